@@ -11,11 +11,16 @@
 
 SOURCES       = door_dataset_parser.cpp \
                 ../common/globalFunctions.cpp \
+                ../common/RCsvTokenizer.cpp \
+                ../common/RRecordWriter.cpp \
+                ../common/RStringPool.cpp \
                 ../common/RTable.cpp \
+                ../common/RTextTemplate.cpp \
                 ../common/Data.cpp \
                 ../common/Datasets.cpp \
                 ../common/EventData.cpp \
                 ../common/Events.cpp \
+                ../common/InfoFileRegistry.cpp \
                 ../common/Params.cpp \
                 ../common/RMemArea.cpp\
                 ../common/RRandomVar.cpp\
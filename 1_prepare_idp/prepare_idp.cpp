@@ -7,13 +7,16 @@
 **
 ****************************************************************************/
 
+#include <QDataStream>
 #include <QDir>
+#include <QScopedPointer>
 
 #include "common/globalVars.h"
 #include "common/globalFunctions.h"
 #include "common/Cruises.h"
 #include "common/Data.h"
 #include "common/Events.h"
+#include "common/InputSnapshot.h"
 #include "common/RTable.h"
 #include "common/Params.h"
 #include "common/RRandomVar.h"
@@ -53,26 +56,70 @@ int main()
   RTable docuByExtPrmName(dataDir+"BOTTLE_DATA_DOCUMENTATION.csv","PARAMETER",comma);
   docuByExtPrmName.insertFile(dataDir+"CELL_DATA_DOCUMENTATION.csv","PARAMETER",comma);
 
-  /* load the cruise information from file */
-  CruisesDB cruisesDB(dataDir+"CRUISES.csv","CRUISE",comma);
-
-  /* load the event information from file */
-  EventsDB::diagnoseEventCorrections();
-  EventsDB eventsDB(dataDir+"EVENTS.csv","BODC_EVENT_NUMBER",comma);
-  eventsDB.insertFile(dataDir+"event_corrections/EVENTS_corrected.csv",
-                      "BODC_EVENT_NUMBER",comma);
-  eventsDB.autoCorrectStationLabels();
+  /* load the list of removed DOoR datasets from file */
+  QStringList ignoredDatasets=fileContents(idpDataSetInpDir+"datasets_ignore.txt");
 
+  /* reload cruises, events, datasets and data items from the binary
+     snapshot if no input file has changed */
+  QStringList snapshotInputs;
+  snapshotInputs << dataDir+"CRUISES.csv"
+                 << dataDir+"EVENTS.csv"
+                 << dataDir+"event_corrections/EVENTS_corrected.csv"
+                 << idpDataSetInpDir+"datasets_ignore.txt"
+                 << idpIntermDir+"datasets/gdac_DataList_essentials.txt"
+                 << dataDir+"BOTTLE_DATA.csv"
+                 << dataDir+"CELL_DATA.csv";
+  InputSnapshot snapshot(idpIntermDir+"snapshots/prepare_idp.snapshot",snapshotInputs);
+
+  QScopedPointer<CruisesDB> cruisesPtr; QScopedPointer<EventsDB> eventsPtr;
+  QScopedPointer<DatasetInfos> datasetsPtr; QScopedPointer<DataItemsDB> dataItemsPtr;
+  if (snapshot.load())
+    {
+      QDataStream& in=snapshot.stream();
+      cruisesPtr.reset(new CruisesDB(in));
+      eventsPtr.reset(new EventsDB(in));
+      datasetsPtr.reset(new DatasetInfos(in,&ignoredDatasets));
+      dataItemsPtr.reset(new DataItemsDB(in,datasetsPtr.data(),eventsPtr.data()));
+      if (!snapshot.isIntact()) dataItemsPtr.reset();
+      snapshot.close();
+    }
 
-  /* load the DOoR dataset information from file */
-  QStringList ignoredDatasets=fileContents(idpDataSetInpDir+"datasets_ignore.txt");
-  DatasetInfos datasetInfos(idpIntermDir+"datasets/gdac_DataList_essentials.txt",
-                            "PARAMETER::BARCODE",tab,&ignoredDatasets);
+  if (!dataItemsPtr)
+    {
+      /* load the cruise information from file */
+      cruisesPtr.reset(new CruisesDB(dataDir+"CRUISES.csv","CRUISE",comma));
+
+      /* load the event information from file */
+      EventsDB::diagnoseEventCorrections();
+      eventsPtr.reset(new EventsDB(dataDir+"EVENTS.csv","BODC_EVENT_NUMBER",comma));
+      eventsPtr->insertFile(dataDir+"event_corrections/EVENTS_corrected.csv",
+                            "BODC_EVENT_NUMBER",comma);
+      eventsPtr->autoCorrectStationLabels();
+
+      /* load the DOoR dataset information from file */
+      datasetsPtr.reset(new DatasetInfos(idpIntermDir+"datasets/gdac_DataList_essentials.txt",
+                                         "PARAMETER::BARCODE",tab,&ignoredDatasets));
+
+      /* load all accepted data records */
+      dataItemsPtr.reset(new DataItemsDB(dataDir+"BOTTLE_DATA.csv",comma,
+                                         datasetsPtr.data(),eventsPtr.data()));
+      dataItemsPtr->appendFile(dataDir+"CELL_DATA.csv",comma);
+
+      /* save the loaded objects for the next run */
+      if (snapshot.create())
+        {
+          QDataStream& out=snapshot.stream();
+          cruisesPtr->writeTo(out); eventsPtr->writeTo(out);
+          datasetsPtr->writeTo(out); dataItemsPtr->writeTo(out);
+          snapshot.commit();
+        }
+    }
 
+  CruisesDB& cruisesDB=*cruisesPtr;
+  EventsDB& eventsDB=*eventsPtr;
+  DatasetInfos& datasetInfos=*datasetsPtr;
+  DataItemsDB& dataItemsDB=*dataItemsPtr;
 
-  /* load all accepted data records */
-  DataItemsDB dataItemsDB(dataDir+"BOTTLE_DATA.csv",comma,&datasetInfos,&eventsDB);
-  dataItemsDB.appendFile(dataDir+"CELL_DATA.csv",comma);
   dataItemsDB.writeDiagnostics(&cruisesDB);
 
   /* load the data records for all dataTypes */
@@ -92,19 +139,19 @@ int main()
 
   /* construct the station lists for all dataTypes */
   StationList seawaterStats=
-    eventsDB.collateStations(seawaterDataItems.acceptedEventNumbers.keys(),15.,5.,&eventsDB);
+    eventsDB.collateStations(seawaterDataItems.acceptedEventNumberList(),15.,5.,&eventsDB);
   seawaterStats.writeSpreadsheetFile(dir,"Seawater_Stations.txt",&eventsDB);
 
   StationList aerosolStats=
-    eventsDB.collateStations(aerosolDataItems.acceptedEventNumbers.keys(),15.,1.,&eventsDB);
+    eventsDB.collateStations(aerosolDataItems.acceptedEventNumberList(),15.,1.,&eventsDB);
   aerosolStats.writeSpreadsheetFile(dir,"Aerosol_Stations.txt",&eventsDB);
 
   StationList precipStats=
-    eventsDB.collateStations(precipDataItems.acceptedEventNumbers.keys(),15.,1.,&eventsDB);
+    eventsDB.collateStations(precipDataItems.acceptedEventNumberList(),15.,1.,&eventsDB);
   precipStats.writeSpreadsheetFile(dir,"Precipitation_Stations.txt",&eventsDB);
 
   StationList cryosphStats=
-    eventsDB.collateStations(cryosphDataItems.acceptedEventNumbers.keys(),15.,1.,&eventsDB);
+    eventsDB.collateStations(cryosphDataItems.acceptedEventNumberList(),15.,1.,&eventsDB);
   cryosphStats.writeSpreadsheetFile(dir,"Cryosphere_Stations.txt",&eventsDB);
 
 
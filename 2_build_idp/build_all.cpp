@@ -7,13 +7,18 @@
 **
 ****************************************************************************/
 
+#include <QDataStream>
 #include <QDir>
+#include <QRunnable>
+#include <QScopedPointer>
+#include <QThreadPool>
 
 #include "common/globalVars.h"
 #include "common/globalFunctions.h"
 #include "common/Cruises.h"
 #include "common/Data.h"
 #include "common/Events.h"
+#include "common/InputSnapshot.h"
 #include "common/RTable.h"
 #include "common/Params.h"
 #include "common/RRandomVar.h"
@@ -26,6 +31,116 @@
 #include "common/RDateTime.h"
 #include "common/systemTools.h"
 
+/**************************************************************************/
+class ProductInputs
+/**************************************************************************/
+/*!
+
+  \brief Read-only inputs shared by all ProductBuilder objects.
+
+*/
+{
+public:
+  EventsDB *eventsDB;
+  CruisesDB *cruisesDB;
+  ParamDB *params;
+  DatasetInfos *datasetInfos;
+  DataItemsDB *dataItemsDB;
+  RTable *docuByExtPrmName;
+  RTable *bioGeotracesInfos;
+  RTable *piInfosByName;
+  RTable *keyVarsByDataVar;
+  RTable *keyVarsByDataVarU;
+  UnitConverter *unitConverter;
+  QMap<char,QString> *bottleFlagDescr;
+};
+
+/**************************************************************************/
+class ProductBuilder : public QRunnable
+/**************************************************************************/
+/*!
+
+  \brief Builds the station list, parameter lists and ODV spreadsheet
+  file of one data type.
+
+  For SeawaterDT, the non-unified and unified products are both built
+  in a single pass over the events, because they share the data items
+  and stations.
+
+*/
+{
+public:
+  ProductBuilder(const ProductInputs *inputs,IdpDataType dataType,int threadCount)
+    : in(inputs),type(dataType),threads(threadCount) { setAutoDelete(false); }
+
+  void run();
+
+private:
+  const ProductInputs *in; //!< pointer to the shared inputs
+  IdpDataType type;        //!< data type
+  int threads;             //!< thread budget of this product
+};
+
+/**************************************************************************/
+void ProductBuilder::run()
+/**************************************************************************/
+/*!
+
+  \brief Builds the products of the data type.
+
+*/
+{
+  /* file name labels of the data type */
+  QString lbl,productName; double timeTolerance=1.;
+  switch (type)
+    {
+    case CryosphereDT:    lbl="Cryosphere"; productName="Cryosphere"; break;
+    case PrecipitationDT: lbl="Precipitation"; productName="Precipitation"; break;
+    case AerosolsDT:      lbl="Aerosol"; productName="Aerosols"; break;
+    case SeawaterDT:      lbl="Seawater"; productName="Seawater";
+                          timeTolerance=5.; break;
+    default:              return;
+    }
+  const QString outFn=QString("GEOTRACES_%1_%2.txt").arg(idpName).arg(productName);
+  const QString dataDir=idpOutputDir+"data/"+productName.toLower();
+
+  /* load the data records for this data type */
+  DataItemList dataItems(type,in->dataItemsDB,in->datasetInfos);
+
+  /* construct the station list for this data type */
+  StationList stations=
+    in->eventsDB->collateStations(dataItems.acceptedEventNumberList(),
+                                  15.,timeTolerance,in->eventsDB);
+  stations.writeSpreadsheetFile(idpDiagnDir+"stations/",
+                                lbl+"_Stations.txt",in->eventsDB);
+
+  /* setup the IDP parameter set - non-unified parameters */
+  ParamSet prms(type,in->params,&dataItems,in->datasetInfos,false);
+  prms.writeParamLists(idpOutputDir+"parameters/",lbl+"_Parameters");
+
+  /* collate meta data and data and write to ODV spreadsheet file */
+  if (type!=SeawaterDT)
+    {
+      prms.writeDataAsSpreadsheet(&stations,in->cruisesDB,
+                                  in->docuByExtPrmName,in->bioGeotracesInfos,
+                                  in->piInfosByName,in->keyVarsByDataVar,
+                                  in->unitConverter,in->bottleFlagDescr,
+                                  dataDir+"/",outFn,threads);
+      return;
+    }
+
+  /* setup the IDP parameter set - unified parameters. both spreadsheet
+     files are written from the same collated events. */
+  ParamSet prmsU(type,in->params,&dataItems,in->datasetInfos,true);
+  prmsU.writeParamLists(idpOutputDir+"parameters/",lbl+"_Parameters_unified");
+  prms.writeDataAsSpreadsheets(&prmsU,&stations,in->cruisesDB,
+                               in->docuByExtPrmName,in->bioGeotracesInfos,
+                               in->piInfosByName,in->keyVarsByDataVar,
+                               in->keyVarsByDataVarU,
+                               in->unitConverter,in->bottleFlagDescr,
+                               dataDir+"/",dataDir+"-unified/",outFn,threads);
+}
+
 /**************************************************************************/
 int main()
 /**************************************************************************/
@@ -37,7 +152,7 @@ int main()
 {
   // const bool unifyPrms=true;
   const QString discreteDataDir=idpDataInpDir+"discrete/";
-  QString inFn,outFn;
+  QString inFn;
 
   /* ************* LOADING *************** */
 
@@ -51,149 +166,138 @@ int main()
   RTable bioGeotracesInfos(idpDataInpDir+"biogeotraces/BioGEOTRACES_Omics.txt",
                             "BODC Bottle Number",tab);
 
-  /* load the bottle and cell data documentation information from file */
-  RTable docuByExtPrmName(discreteDataDir+"BOTTLE_DATA_DOCUMENTATION.csv","PARAMETER",comma);
-  docuByExtPrmName.insertFile(discreteDataDir+"CELL_DATA_DOCUMENTATION.csv","PARAMETER",comma);
-
-  /* load the cruise information from file */
-  CruisesDB cruisesDB(discreteDataDir+"CRUISES.csv","CRUISE",comma);
-
-  /* load the event information from file */
-  EventsDB::diagnoseEventCorrections();
-  EventsDB eventsDB(discreteDataDir+"EVENTS.csv","BODC_EVENT_NUMBER",comma);
-  eventsDB.insertFile(discreteDataDir+"event_corrections/EVENTS_corrected.csv",
-                      "BODC_EVENT_NUMBER",comma);
-  eventsDB.autoCorrectStationLabels();
-
   /* load the PI information from file */
   RTable piInfosByName(idpIntermDir+"datasets/orcid_list.txt","NAME",tab);
 
-  /* load all IDP parameter definitions */
-  ParamDB params(idpIntermDir+"parameters/");
-
   /* load the key variable associations from file, both unified and non-unified versions */
   RTable keyVarsByDataVar(idpPrmListInpDir+"_KEY_VARIABLES.txt","DATA VARIABLE",tab);
   RTable keyVarsByDataVarU(idpPrmListInpDir+"_UNIFIED_KEY_VARIABLES.txt","DATA VARIABLE",tab);
 
-  /* load the DOoR dataset information from file */
+  /* load the list of removed DOoR datasets from file */
   QStringList ignoredDatasets=fileContents(idpDataSetInpDir+"datasets_ignore.txt");
-  DatasetInfos datasetInfos(idpIntermDir+"datasets/gdac_DataList_essentials.txt",
-                            "PARAMETER::BARCODE",tab,&ignoredDatasets);
-  datasetInfos.writeContributingScientistsInfo(piInfosByName);
-
-  /* load data records, ignore records without S&I approval or PI permission */
-  DataItemsDB dataItemsDB(discreteDataDir+"BOTTLE_DATA.csv",comma,&datasetInfos,&eventsDB);
-  dataItemsDB.appendFile(discreteDataDir+"CELL_DATA.csv",comma);
-  dataItemsDB.aggregateSubSamples();
-
-
-  /* ************* CryosphereDT *************** */
-
-  /* load the data records for CryosphereDT */
-  DataItemList cryosphDataItems(CryosphereDT,&dataItemsDB,&datasetInfos);
 
-  /* construct the station list for CryosphereDT */
-  StationList cryosphStations=
-    eventsDB.collateStations(cryosphDataItems.acceptedEventNumbers.keys(),15.,1.,&eventsDB);
-  cryosphStations.writeSpreadsheetFile(idpDiagnDir+"stations/",
-                                       "Cryosphere_Stations.txt",&eventsDB);
+  /* reload documentation, cruises, events, parameters, datasets and
+     data items from the binary snapshot if no input file has changed */
+  QStringList snapshotInputs;
+  snapshotInputs << discreteDataDir+"BOTTLE_DATA_DOCUMENTATION.csv"
+                 << discreteDataDir+"CELL_DATA_DOCUMENTATION.csv"
+                 << discreteDataDir+"CRUISES.csv"
+                 << discreteDataDir+"EVENTS.csv"
+                 << discreteDataDir+"event_corrections/EVENTS_corrected.csv"
+                 << idpDataSetInpDir+"datasets_ignore.txt"
+                 << idpIntermDir+"datasets/gdac_DataList_essentials.txt"
+                 << discreteDataDir+"BOTTLE_DATA.csv"
+                 << discreteDataDir+"CELL_DATA.csv";
+  QStringList prmFns=QDir(idpIntermDir+"parameters/")
+    .entryList(QStringList("*_parameters.txt"),QDir::Files,QDir::Name);
+  for (int i=0; i<prmFns.size(); ++i)
+    snapshotInputs << idpIntermDir+"parameters/"+prmFns.at(i);
+  InputSnapshot snapshot(idpIntermDir+"snapshots/build_all.snapshot",snapshotInputs);
+
+  QScopedPointer<RTable> docuPtr; QScopedPointer<CruisesDB> cruisesPtr;
+  QScopedPointer<EventsDB> eventsPtr; QScopedPointer<ParamDB> paramsPtr;
+  QScopedPointer<DatasetInfos> datasetsPtr; QScopedPointer<DataItemsDB> dataItemsPtr;
+  if (snapshot.load())
+    {
+      QDataStream& in=snapshot.stream();
+      docuPtr.reset(new RTable(in));
+      cruisesPtr.reset(new CruisesDB(in));
+      eventsPtr.reset(new EventsDB(in));
+      paramsPtr.reset(new ParamDB(in));
+      datasetsPtr.reset(new DatasetInfos(in,&ignoredDatasets));
+      dataItemsPtr.reset(new DataItemsDB(in,datasetsPtr.data(),eventsPtr.data()));
+      if (!snapshot.isIntact()) dataItemsPtr.reset();
+      snapshot.close();
+    }
+
+  if (!dataItemsPtr)
+    {
+      /* load the bottle and cell data documentation information from file */
+      docuPtr.reset(new RTable(discreteDataDir+"BOTTLE_DATA_DOCUMENTATION.csv",
+                               "PARAMETER",comma));
+      docuPtr->insertFile(discreteDataDir+"CELL_DATA_DOCUMENTATION.csv","PARAMETER",comma);
+
+      /* load the cruise information from file */
+      cruisesPtr.reset(new CruisesDB(discreteDataDir+"CRUISES.csv","CRUISE",comma));
+
+      /* load the event information from file */
+      EventsDB::diagnoseEventCorrections();
+      eventsPtr.reset(new EventsDB(discreteDataDir+"EVENTS.csv","BODC_EVENT_NUMBER",comma));
+      eventsPtr->insertFile(discreteDataDir+"event_corrections/EVENTS_corrected.csv",
+                            "BODC_EVENT_NUMBER",comma);
+      eventsPtr->autoCorrectStationLabels();
+
+      /* load all IDP parameter definitions */
+      paramsPtr.reset(new ParamDB(idpIntermDir+"parameters/"));
+
+      /* load the DOoR dataset information from file */
+      datasetsPtr.reset(new DatasetInfos(idpIntermDir+"datasets/gdac_DataList_essentials.txt",
+                                         "PARAMETER::BARCODE",tab,&ignoredDatasets));
+
+      /* load data records, ignore records without S&I approval or PI permission */
+      dataItemsPtr.reset(new DataItemsDB(discreteDataDir+"BOTTLE_DATA.csv",comma,
+                                         datasetsPtr.data(),eventsPtr.data()));
+      dataItemsPtr->appendFile(discreteDataDir+"CELL_DATA.csv",comma);
+      dataItemsPtr->aggregateSubSamples();
+
+      /* save the loaded objects for the next run */
+      if (snapshot.create())
+        {
+          QDataStream& out=snapshot.stream();
+          docuPtr->writeTo(out); cruisesPtr->writeTo(out);
+          eventsPtr->writeTo(out); paramsPtr->writeTo(out);
+          datasetsPtr->writeTo(out); dataItemsPtr->writeTo(out);
+          snapshot.commit();
+        }
+    }
+
+  RTable& docuByExtPrmName=*docuPtr;
+  CruisesDB& cruisesDB=*cruisesPtr;
+  EventsDB& eventsDB=*eventsPtr;
+  ParamDB& params=*paramsPtr;
+  DatasetInfos& datasetInfos=*datasetsPtr;
+  DataItemsDB& dataItemsDB=*dataItemsPtr;
 
-  /* setup the IDP parameter set for CryosphereDT */
-  ParamSet cryosphPrms(CryosphereDT,&params,&cryosphDataItems,&datasetInfos);
-  cryosphPrms.writeParamLists(idpOutputDir+"parameters/","Cryosphere_Parameters");
-
-  /* collate meta data and data and write to ODV spreadsheet file */
-  outFn=QString("GEOTRACES_%1_Cryosphere.txt").arg(idpName);
-  cryosphPrms.writeDataAsSpreadsheet(&cryosphStations,&cruisesDB,
-                                     &docuByExtPrmName,&bioGeotracesInfos,
-                                     &piInfosByName,&keyVarsByDataVar,
-                                     &unitConverter,&bottleFlagDescr,
-                                     idpOutputDir+"data/cryosphere/",outFn);
-
-  /* ************* PrecipitationDT *************** */
-
-  /* load the data records for PrecipitationDT */
-  DataItemList precipDataItems(PrecipitationDT,&dataItemsDB,&datasetInfos);
-
-  /* construct the station list for PrecipitationDT */
-  StationList precipStations=
-    eventsDB.collateStations(precipDataItems.acceptedEventNumbers.keys(),15.,1.,&eventsDB);
-  precipStations.writeSpreadsheetFile(idpDiagnDir+"stations/",
-                                      "Precipitation_Stations.txt",&eventsDB);
-
-  /* setup the IDP parameter set for PrecipitationDT */
-  ParamSet precipPrms(PrecipitationDT,&params,&precipDataItems,&datasetInfos);
-  precipPrms.writeParamLists(idpOutputDir+"parameters/","Precipitation_Parameters");
-
-  /* collate meta data and data and write to ODV spreadsheet file */
-  outFn=QString("GEOTRACES_%1_Precipitation.txt").arg(idpName);
-  precipPrms.writeDataAsSpreadsheet(&precipStations,&cruisesDB,
-                                    &docuByExtPrmName,&bioGeotracesInfos,
-                                    &piInfosByName,&keyVarsByDataVar,
-                                    &unitConverter,&bottleFlagDescr,
-                                    idpOutputDir+"data/precipitation/",outFn);
-
-  /* ************* AerosolsDT *************** */
-
-  /* load the data records for AerosolsDT */
-  DataItemList aerosolDataItems(AerosolsDT,&dataItemsDB,&datasetInfos);
-
-  /* construct the station list for AerosolsDT */
-  StationList aerosolStations=
-    eventsDB.collateStations(aerosolDataItems.acceptedEventNumbers.keys(),15.,1.,&eventsDB);
-  aerosolStations.writeSpreadsheetFile(idpDiagnDir+"stations/",
-                                       "Aerosol_Stations.txt",&eventsDB);
+  datasetInfos.writeContributingScientistsInfo(piInfosByName);
 
-  /* setup the IDP parameter set for AerosolsDT */
-  ParamSet aerosolPrms(AerosolsDT,&params,&aerosolDataItems,&datasetInfos);
-  aerosolPrms.writeParamLists(idpOutputDir+"parameters/","Aerosol_Parameters");
 
-  /* collate meta data and data and write to ODV spreadsheet file */
-  outFn=QString("GEOTRACES_%1_Aerosols.txt").arg(idpName);
-  aerosolPrms.writeDataAsSpreadsheet(&aerosolStations,&cruisesDB,
-                                     &docuByExtPrmName,&bioGeotracesInfos,
-                                     &piInfosByName,&keyVarsByDataVar,
-                                     &unitConverter,&bottleFlagDescr,
-                                     idpOutputDir+"data/aerosols/",outFn);
-
-  /* ************* SeawaterDT *************** */
-
-  /* load the data records for SeawaterDT */
-  DataItemList seawaterDataItems(SeawaterDT,&dataItemsDB,&datasetInfos);
-
-  /* construct the station list for SeawaterDT */
-  StationList seawaterStations=
-    eventsDB.collateStations(seawaterDataItems.acceptedEventNumbers.keys(),15.,5.,&eventsDB);
-  seawaterStations.writeSpreadsheetFile(idpDiagnDir+"stations/",
-                                        "Seawater_Stations.txt",&eventsDB);
-
-
-  /* setup the IDP parameter set for SeawaterDT - non-unified parameters */
-  ParamSet seawaterPrms(SeawaterDT,&params,&seawaterDataItems,&datasetInfos,false);
-  // seawaterPrms.writeDescriptions(idpDiagnDir+"parameters/","_UNIFIED_PARAMETER_DESCRIPTIONS.txt");
-  seawaterPrms.writeParamLists(idpOutputDir+"parameters/","Seawater_Parameters");
-
-  /* collate meta data and data and write to ODV spreadsheet file - non-unified parameters */
-  outFn=QString("GEOTRACES_%1_Seawater.txt").arg(idpName);
-  seawaterPrms.writeDataAsSpreadsheet(&seawaterStations,&cruisesDB,
-                                      &docuByExtPrmName,&bioGeotracesInfos,
-                                      &piInfosByName,&keyVarsByDataVar,
-                                      &unitConverter,&bottleFlagDescr,
-                                      idpOutputDir+"data/seawater/",outFn);
-
-
-  /* setup the IDP parameter set for SeawaterDT - unified parameters */
-  ParamSet seawaterPrmsU(SeawaterDT,&params,&seawaterDataItems,&datasetInfos,true);
-  // seawaterPrmsU.writeDescriptions(idpDiagnDir+"parameters/","_UNIFIED_PARAMETER_DESCRIPTIONS.txt");
-  seawaterPrmsU.writeParamLists(idpOutputDir+"parameters/","Seawater_Parameters_unified");
-
-  /* collate meta data and data and write to ODV spreadsheet file - unified parameters */
-  outFn=QString("GEOTRACES_%1_Seawater.txt").arg(idpName);
-  seawaterPrmsU.writeDataAsSpreadsheet(&seawaterStations,&cruisesDB,
-                                       &docuByExtPrmName,&bioGeotracesInfos,
-                                       &piInfosByName,&keyVarsByDataVarU,
-                                       &unitConverter,&bottleFlagDescr,
-                                       idpOutputDir+"data/seawater-unified/",outFn);
+  /* ************* DATA TYPE PRODUCTS *************** */
+
+  ProductInputs inputs;
+  inputs.eventsDB=&eventsDB; inputs.cruisesDB=&cruisesDB; inputs.params=&params;
+  inputs.datasetInfos=&datasetInfos; inputs.dataItemsDB=&dataItemsDB;
+  inputs.docuByExtPrmName=&docuByExtPrmName; inputs.bioGeotracesInfos=&bioGeotracesInfos;
+  inputs.piInfosByName=&piInfosByName; inputs.keyVarsByDataVar=&keyVarsByDataVar;
+  inputs.keyVarsByDataVarU=&keyVarsByDataVarU; inputs.unitConverter=&unitConverter;
+  inputs.bottleFlagDescr=&bottleFlagDescr;
+
+  const int threadCount=workerThreadCount();
+  if (idpConcurrentProducts<2 || threadCount<2)
+    {
+      /* build the products one after the other */
+      ProductBuilder cryosph(&inputs,CryosphereDT,threadCount); cryosph.run();
+      ProductBuilder precip(&inputs,PrecipitationDT,threadCount); precip.run();
+      ProductBuilder aerosol(&inputs,AerosolsDT,threadCount); aerosol.run();
+      ProductBuilder seawater(&inputs,SeawaterDT,threadCount); seawater.run();
+    }
+  else
+    {
+      /* build the products concurrently. Seawater is by far the largest
+         data type. It is started first and receives most of the thread
+         budget, so that the small data types finish while Seawater is
+         still being written. */
+      const int smallCount=qMax(1,threadCount/8);
+      const int seawaterCount=qMax(1,threadCount-3*smallCount);
+      ProductBuilder seawater(&inputs,SeawaterDT,seawaterCount);
+      ProductBuilder cryosph(&inputs,CryosphereDT,smallCount);
+      ProductBuilder precip(&inputs,PrecipitationDT,smallCount);
+      ProductBuilder aerosol(&inputs,AerosolsDT,smallCount);
+
+      QThreadPool pool; pool.setMaxThreadCount(idpConcurrentProducts);
+      pool.start(&seawater); pool.start(&cryosph);
+      pool.start(&precip); pool.start(&aerosol);
+      pool.waitForDone();
+    }
 
   return 0;
 }
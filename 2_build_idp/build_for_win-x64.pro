@@ -16,7 +16,13 @@ SOURCES       = build_all.cpp \
                 ../common/Datasets.cpp \
                 ../common/EventData.cpp \
                 ../common/Events.cpp \
+                ../common/InfoFileRegistry.cpp \
+                ../common/InputSnapshot.cpp \
+                ../common/RCsvTokenizer.cpp \
+                ../common/RRecordWriter.cpp \
+                ../common/RStringPool.cpp \
                 ../common/RTable.cpp \
+                ../common/RTextTemplate.cpp \
                 ../common/Params.cpp \
                 ../common/RMemArea.cpp\
                 ../common/RRandomVar.cpp\
@@ -20,7 +20,32 @@ CruisesDB::CruisesDB(const QString& fn,const QString& keyLabel,QChar splitChar)
 
 */
 {
-/* determine various column indexes */
+  setColumnIndexes();
+}
+
+/**************************************************************************/
+CruisesDB::CruisesDB(QDataStream& in)
+  : RTable(in)
+/**************************************************************************/
+/*!
+
+  \brief Creates a CruisesDB object and reads the cruises from binary
+  stream \a in (see RTable::writeTo()).
+
+*/
+{
+  setColumnIndexes();
+}
+
+/**************************************************************************/
+void CruisesDB::setColumnIndexes()
+/**************************************************************************/
+/*!
+
+  \brief Determines the indexes of the columns used by this class.
+
+*/
+{
   idxCruise=columnIndexOf("CRUISE");
   idxAliases=columnIndexOf("ALIASES");
   idxCountry=columnIndexOf("COUNTRY");
@@ -27,6 +27,9 @@ class CruisesDB : public RTable
 {
 public:
   CruisesDB(const QString& fn,const QString& keyLabel,QChar splitChar);
+  CruisesDB(QDataStream& in);
+
+  void setColumnIndexes();
 
   int idxCruise,idxAliases,idxCountry,idxShipName,idxChiefScientist;
   int idxStartTimeDate,idxEndTimeDate,idxLocation,idxGeotracesPi;
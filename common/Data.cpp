@@ -9,7 +9,15 @@
 
 #include "Data.h"
 
+#include <algorithm>
+
+#include <QDataStream>
 #include <QDir>
+#include <QFile>
+#include <QIODevice>
+#include <QRunnable>
+#include <QTextStream>
+#include <QThreadPool>
 
 #include "globalVars.h"
 #include "globalFunctions.h"
@@ -20,6 +28,95 @@
 #include "RRandomVar.h"
 
 #include "common/odv.h"
+#include "common/systemTools.h"
+
+
+/**************************************************************************/
+class DataItemsWorker : public QRunnable
+/**************************************************************************/
+/*!
+
+  \brief Parses and filters the data lines in one byte range of a
+  memory mapped data file.
+
+*/
+{
+public:
+  DataItemsWorker(const DataItemsDB *dataItemsDB,const RCsvTokenizer *tok,
+                  qint64 startPos,qint64 endPos,DataItemBatch *batch)
+    : dbPtr(dataItemsDB),tokPtr(tok),start(startPos),end(endPos),
+      batchPtr(batch) { setAutoDelete(false); }
+
+  void run()
+  {
+    qint64 pos=start; RCsvField line; QVector<RCsvField> fields;
+    DataItemsDB *db=const_cast<DataItemsDB*>(dbPtr);
+    while (tokPtr->nextLine(pos,end,line))
+      {
+        if (line.isEmpty()) continue;
+        tokPtr->split(line,fields);
+        dbPtr->filterItem(DataItem(db,fields),*batchPtr);
+      }
+  }
+
+private:
+  const DataItemsDB *dbPtr;    //!< pointer to the parent DataItemsDB
+  const RCsvTokenizer *tokPtr; //!< pointer to the file tokenizer
+  qint64 start;                //!< first byte position of range
+  qint64 end;                  //!< byte position after range
+  DataItemBatch *batchPtr;     //!< pointer to the result container
+};
+
+/**************************************************************************/
+template <typename T>
+static void writeColumn(QDataStream& out,const QVector<T>& col)
+/**************************************************************************/
+/*!
+
+  \brief Writes the elements of \a col as raw bytes to \a out.
+
+*/
+{
+  out << (qint32) col.size();
+  out.writeRawData((const char*) col.constData(),col.size()*sizeof(T));
+}
+
+/**************************************************************************/
+template <typename T>
+static bool readColumn(QDataStream& in,QVector<T>& col)
+/**************************************************************************/
+/*!
+
+  \brief Reads the elements written by writeColumn() from \a in into
+  \a col.
+
+  \return \c true if successful, or \c false otherwise.
+
+*/
+{
+  qint32 n; in >> n; qint64 byteCount=((qint64) n)*sizeof(T);
+  if (in.status()!=QDataStream::Ok || n<0 ||
+      byteCount>in.device()->bytesAvailable())
+    { in.setStatus(QDataStream::ReadCorruptData); col.clear(); return false; }
+
+  col.resize(n);
+  return in.readRawData((char*) col.data(),byteCount)==byteCount;
+}
+
+/**************************************************************************/
+static void remapStrIds(QVector<int>& strIds,const QVector<int>& idMap)
+/**************************************************************************/
+/*!
+
+  \brief Replaces every string ID in \a strIds by its mapped value
+  \a idMap. IDs outside \a idMap are replaced by 0.
+
+*/
+{
+  int i,id,n=strIds.size(),m=idMap.size(); int *p=strIds.data();
+  for (i=0; i<n; ++i)
+    { id=p[i]; p[i]=(id>=0 && id<m) ? idMap.at(id) : 0; }
+}
 
 
 /**************************************************************************/
@@ -41,16 +138,17 @@ DataItem::DataItem(DataItemsDB *dataItemDB,const QString& line,QChar splitChar)
   rosetteBottleNumber=extractedInt(sl.at(dataItemDB->idxRosetteBottleNumber));
   subSampleNumber=(dataItemDB->idxSubSampleId>-1) ?
     extractedInt(sl.at(dataItemDB->idxSubSampleId)) : -1;
-  cellSampleId=sl.at(dataItemDB->idxcellSampleId);
-  geotracesSampleId=sl.at(dataItemDB->idxGeotracesSampleId);
+  RStringPool& pool=RStringPool::global();
+  cellSampleStrId=pool.intern(sl.at(dataItemDB->idxcellSampleId));
+  geotracesSampleStrId=pool.intern(sl.at(dataItemDB->idxGeotracesSampleId));
   bodcBottleFlag=sl.at(dataItemDB->idxBottleFlag).at(0).toLatin1();
   depth=extractedDouble(sl.at(dataItemDB->idxDepth));
   pressure=extractedDouble(sl.at(dataItemDB->idxPressure));
-  parameter=sl.at(dataItemDB->idxParameter);
+  parameterStrId=pool.intern(sl.at(dataItemDB->idxParameter));
   parameterValue=extractedDouble(sl.at(dataItemDB->idxParameterValue));
   standardDevValue=extractedDouble(sl.at(dataItemDB->idxParameterStDev));
   flag=sl.at(dataItemDB->idxFlag).at(0).toLatin1();
-  unit=sl.at(dataItemDB->idxUnits);
+  unitStrId=pool.intern(sl.at(dataItemDB->idxUnits));
 
   double dmy;
   if (rosetteBottleNumber==ODV::missINT32)
@@ -58,6 +156,72 @@ DataItem::DataItem(DataItemsDB *dataItemDB,const QString& line,QChar splitChar)
   if (depth==ODV::missDOUBLE && pressure==ODV::missDOUBLE)
     dmy=1.0;
 
+  completeDepthPressure();
+}
+
+/**************************************************************************/
+DataItem::DataItem(DataItemsDB *dataItemDB,QVector<RCsvField>& fields)
+/**************************************************************************/
+/*!
+
+  \brief Creates a DataItem object and retrieves its values from the
+  column values \a fields obtained by a RCsvTokenizer.
+
+  Numeric columns are converted directly from the mapped file buffer.
+  String valued columns are interned in the global RStringPool, which
+  allocates memory only for strings not seen before. Missing columns
+  are treated as empty.
+
+*/
+{
+  int i,columnCount=fields.size();
+  for (i=0; i<columnCount; ++i)
+    fields[i].stripEnclosingChars('"','"');
+
+  RCsvField fEmpty; RStringPool& pool=RStringPool::global();
+#define FIELD(idx) (((idx)>-1 && (idx)<columnCount) ? fields.at(idx) : fEmpty)
+#define STRID(idx) pool.intern(FIELD(idx).ptr,FIELD(idx).len)
+  bool ok; int iv; double dv;
+
+  iv=FIELD(dataItemDB->idxEventNumber).toInt(&ok);
+  eventNumber=ok ? iv : ODV::missINT32;
+  iv=FIELD(dataItemDB->idxBottleNumber).toInt(&ok);
+  bodcBottleNumber=ok ? iv : ODV::missINT32;
+  iv=FIELD(dataItemDB->idxRosetteBottleNumber).toInt(&ok);
+  rosetteBottleNumber=ok ? iv : ODV::missINT32;
+  iv=FIELD(dataItemDB->idxSubSampleId).toInt(&ok);
+  subSampleNumber=(dataItemDB->idxSubSampleId>-1) ?
+    (ok ? iv : ODV::missINT32) : -1;
+  cellSampleStrId=STRID(dataItemDB->idxcellSampleId);
+  geotracesSampleStrId=STRID(dataItemDB->idxGeotracesSampleId);
+  bodcBottleFlag=FIELD(dataItemDB->idxBottleFlag).firstChar();
+  dv=FIELD(dataItemDB->idxDepth).toDouble(&ok);
+  depth=ok ? dv : ODV::missDOUBLE;
+  dv=FIELD(dataItemDB->idxPressure).toDouble(&ok);
+  pressure=ok ? dv : ODV::missDOUBLE;
+  parameterStrId=STRID(dataItemDB->idxParameter);
+  dv=FIELD(dataItemDB->idxParameterValue).toDouble(&ok);
+  parameterValue=ok ? dv : ODV::missDOUBLE;
+  dv=FIELD(dataItemDB->idxParameterStDev).toDouble(&ok);
+  standardDevValue=ok ? dv : ODV::missDOUBLE;
+  flag=FIELD(dataItemDB->idxFlag).firstChar();
+  unitStrId=STRID(dataItemDB->idxUnits);
+#undef STRID
+#undef FIELD
+
+  completeDepthPressure();
+}
+
+/**************************************************************************/
+void DataItem::completeDepthPressure()
+/**************************************************************************/
+/*!
+
+  \brief Calculates depth from pressure or pressure from depth, if
+  only one of the two is available.
+
+*/
+{
   if (depth==ODV::missDOUBLE && pressure!=ODV::missDOUBLE)
     depth=calDepthEOS80(pressure,0.);
   if (pressure==ODV::missDOUBLE && depth!=ODV::missDOUBLE)
@@ -74,7 +238,7 @@ int DataItem::paramId(ParamSet *paramSet)
 
 */
 {
-  return paramSet->paramIdFor(Param::paramNameFromExtendedName(parameter));
+  return paramSet->paramIdFor(Param::paramNameFromExtendedName(parameter()));
 }
 
 /**************************************************************************/
@@ -94,54 +258,348 @@ QString DataItem::toString(QChar sepChar) const
     +QString::number(bodcBottleNumber)+sepChar
     +rbn+sepChar
     +QString(bodcBottleFlag)+sepChar
-    +geotracesSampleId+sepChar
+    +geotracesSampleId()+sepChar
     +QString::number(depth)+sepChar
     +QString::number(pressure)+sepChar
-    +cellSampleId+sepChar
+    +cellSampleId()+sepChar
     +QString::number(subSampleNumber)+sepChar
-    +parameter+sepChar
+    +parameter()+sepChar
     +QString::number(parameterValue)+sepChar
     +std+sepChar
     +QString(flag)+sepChar
-    +unit+sepChar;
+    +unit()+sepChar;
+}
+
+
+
+/**************************************************************************/
+void DataItemStore::append(const DataItem& di)
+/**************************************************************************/
+/*!
+
+  \brief Appends data item \a di.
+
+*/
+{
+  eventNumbers.append(di.eventNumber);
+  bodcBottleNumbers.append(di.bodcBottleNumber);
+  rosetteBottleNumbers.append(di.rosetteBottleNumber);
+  subSampleNumbers.append(di.subSampleNumber);
+  geotracesSampleStrIds.append(di.geotracesSampleStrId);
+  cellSampleStrIds.append(di.cellSampleStrId);
+  bodcBottleFlags.append(di.bodcBottleFlag);
+  depths.append(di.depth);
+  pressures.append(di.pressure);
+  parameterStrIds.append(di.parameterStrId);
+  parameterValues.append(di.parameterValue);
+  standardDevValues.append(di.standardDevValue);
+  flags.append(di.flag);
+  unitStrIds.append(di.unitStrId);
+}
+
+/**************************************************************************/
+void DataItemStore::append(const DataItemStore& other)
+/**************************************************************************/
+/*!
+
+  \brief Appends all data items of \a other.
+
+*/
+{
+  eventNumbers+=other.eventNumbers;
+  bodcBottleNumbers+=other.bodcBottleNumbers;
+  rosetteBottleNumbers+=other.rosetteBottleNumbers;
+  subSampleNumbers+=other.subSampleNumbers;
+  geotracesSampleStrIds+=other.geotracesSampleStrIds;
+  cellSampleStrIds+=other.cellSampleStrIds;
+  bodcBottleFlags+=other.bodcBottleFlags;
+  depths+=other.depths;
+  pressures+=other.pressures;
+  parameterStrIds+=other.parameterStrIds;
+  parameterValues+=other.parameterValues;
+  standardDevValues+=other.standardDevValues;
+  flags+=other.flags;
+  unitStrIds+=other.unitStrIds;
+}
+
+/**************************************************************************/
+DataItem DataItemStore::at(int idx) const
+/**************************************************************************/
+/*!
+
+  \brief \return A copy of the data item at index \a idx.
+
+*/
+{
+  DataItem di;
+  di.eventNumber=eventNumbers.at(idx);
+  di.bodcBottleNumber=bodcBottleNumbers.at(idx);
+  di.rosetteBottleNumber=rosetteBottleNumbers.at(idx);
+  di.subSampleNumber=subSampleNumbers.at(idx);
+  di.geotracesSampleStrId=geotracesSampleStrIds.at(idx);
+  di.cellSampleStrId=cellSampleStrIds.at(idx);
+  di.bodcBottleFlag=bodcBottleFlags.at(idx);
+  di.depth=depths.at(idx);
+  di.pressure=pressures.at(idx);
+  di.parameterStrId=parameterStrIds.at(idx);
+  di.parameterValue=parameterValues.at(idx);
+  di.standardDevValue=standardDevValues.at(idx);
+  di.flag=flags.at(idx);
+  di.unitStrId=unitStrIds.at(idx);
+  return di;
+}
+
+/**************************************************************************/
+void DataItemStore::clear()
+/**************************************************************************/
+/*!
+
+  \brief Removes all data items.
+
+*/
+{
+  *this=DataItemStore();
+}
+
+/**************************************************************************/
+bool DataItemStore::readFrom(QDataStream& in,const QVector<int>& strIdMap)
+/**************************************************************************/
+/*!
+
+  \brief Replaces the contents with the data items read from binary
+  stream \a in (see writeTo()).
+
+  String IDs are translated to the global string pool using \a
+  strIdMap (see RStringPool::internFrom()).
+
+  \return \c true if successful, or \c false otherwise.
+
+*/
+{
+  bool ok=readColumn(in,eventNumbers) &&
+    readColumn(in,bodcBottleNumbers) &&
+    readColumn(in,rosetteBottleNumbers) &&
+    readColumn(in,subSampleNumbers) &&
+    readColumn(in,geotracesSampleStrIds) &&
+    readColumn(in,cellSampleStrIds) &&
+    readColumn(in,bodcBottleFlags) &&
+    readColumn(in,depths) &&
+    readColumn(in,pressures) &&
+    readColumn(in,parameterStrIds) &&
+    readColumn(in,parameterValues) &&
+    readColumn(in,standardDevValues) &&
+    readColumn(in,flags) &&
+    readColumn(in,unitStrIds);
+  if (!ok) { clear(); return false; }
+
+  remapStrIds(geotracesSampleStrIds,strIdMap);
+  remapStrIds(cellSampleStrIds,strIdMap);
+  remapStrIds(parameterStrIds,strIdMap);
+  remapStrIds(unitStrIds,strIdMap);
+  return true;
+}
+
+/**************************************************************************/
+void DataItemStore::removeAt(int idx)
+/**************************************************************************/
+/*!
+
+  \brief Removes the data item at index \a idx.
+
+*/
+{
+  eventNumbers.remove(idx);
+  bodcBottleNumbers.remove(idx);
+  rosetteBottleNumbers.remove(idx);
+  subSampleNumbers.remove(idx);
+  geotracesSampleStrIds.remove(idx);
+  cellSampleStrIds.remove(idx);
+  bodcBottleFlags.remove(idx);
+  depths.remove(idx);
+  pressures.remove(idx);
+  parameterStrIds.remove(idx);
+  parameterValues.remove(idx);
+  standardDevValues.remove(idx);
+  flags.remove(idx);
+  unitStrIds.remove(idx);
+}
+
+/**************************************************************************/
+void DataItemStore::removeMarked(const QVector<bool>& isRemoved)
+/**************************************************************************/
+/*!
+
+  \brief Removes all data items whose entry in \a isRemoved is \c
+  true, preserving the order of the remaining items.
+
+*/
+{
+  int i,k=0,n=size();
+  for (i=0; i<n; ++i)
+    {
+      if (isRemoved.at(i)) continue;
+      if (k<i)
+        {
+          eventNumbers[k]=eventNumbers.at(i);
+          bodcBottleNumbers[k]=bodcBottleNumbers.at(i);
+          rosetteBottleNumbers[k]=rosetteBottleNumbers.at(i);
+          subSampleNumbers[k]=subSampleNumbers.at(i);
+          geotracesSampleStrIds[k]=geotracesSampleStrIds.at(i);
+          cellSampleStrIds[k]=cellSampleStrIds.at(i);
+          bodcBottleFlags[k]=bodcBottleFlags.at(i);
+          depths[k]=depths.at(i);
+          pressures[k]=pressures.at(i);
+          parameterStrIds[k]=parameterStrIds.at(i);
+          parameterValues[k]=parameterValues.at(i);
+          standardDevValues[k]=standardDevValues.at(i);
+          flags[k]=flags.at(i);
+          unitStrIds[k]=unitStrIds.at(i);
+        }
+      ++k;
+    }
+
+  eventNumbers.resize(k); bodcBottleNumbers.resize(k);
+  rosetteBottleNumbers.resize(k); subSampleNumbers.resize(k);
+  geotracesSampleStrIds.resize(k); cellSampleStrIds.resize(k);
+  bodcBottleFlags.resize(k); depths.resize(k); pressures.resize(k);
+  parameterStrIds.resize(k); parameterValues.resize(k);
+  standardDevValues.resize(k); flags.resize(k); unitStrIds.resize(k);
+}
+
+/**************************************************************************/
+void DataItemStore::replace(int idx,const DataItem& di)
+/**************************************************************************/
+/*!
+
+  \brief Replaces the data item at index \a idx with \a di.
+
+*/
+{
+  eventNumbers[idx]=di.eventNumber;
+  bodcBottleNumbers[idx]=di.bodcBottleNumber;
+  rosetteBottleNumbers[idx]=di.rosetteBottleNumber;
+  subSampleNumbers[idx]=di.subSampleNumber;
+  geotracesSampleStrIds[idx]=di.geotracesSampleStrId;
+  cellSampleStrIds[idx]=di.cellSampleStrId;
+  bodcBottleFlags[idx]=di.bodcBottleFlag;
+  depths[idx]=di.depth;
+  pressures[idx]=di.pressure;
+  parameterStrIds[idx]=di.parameterStrId;
+  parameterValues[idx]=di.parameterValue;
+  standardDevValues[idx]=di.standardDevValue;
+  flags[idx]=di.flag;
+  unitStrIds[idx]=di.unitStrId;
+}
+
+/**************************************************************************/
+void DataItemStore::reserve(int n)
+/**************************************************************************/
+/*!
+
+  \brief Reserves space for \a n data items.
+
+*/
+{
+  eventNumbers.reserve(n);
+  bodcBottleNumbers.reserve(n);
+  rosetteBottleNumbers.reserve(n);
+  subSampleNumbers.reserve(n);
+  geotracesSampleStrIds.reserve(n);
+  cellSampleStrIds.reserve(n);
+  bodcBottleFlags.reserve(n);
+  depths.reserve(n);
+  pressures.reserve(n);
+  parameterStrIds.reserve(n);
+  parameterValues.reserve(n);
+  standardDevValues.reserve(n);
+  flags.reserve(n);
+  unitStrIds.reserve(n);
+}
+
+/**************************************************************************/
+void DataItemStore::writeTo(QDataStream& out) const
+/**************************************************************************/
+/*!
+
+  \brief Writes all data items column by column to binary stream \a
+  out.
+
+  String fields are written as IDs of the global string pool, which
+  must be written as well (see RStringPool::writeTo()).
+
+*/
+{
+  writeColumn(out,eventNumbers);
+  writeColumn(out,bodcBottleNumbers);
+  writeColumn(out,rosetteBottleNumbers);
+  writeColumn(out,subSampleNumbers);
+  writeColumn(out,geotracesSampleStrIds);
+  writeColumn(out,cellSampleStrIds);
+  writeColumn(out,bodcBottleFlags);
+  writeColumn(out,depths);
+  writeColumn(out,pressures);
+  writeColumn(out,parameterStrIds);
+  writeColumn(out,parameterValues);
+  writeColumn(out,standardDevValues);
+  writeColumn(out,flags);
+  writeColumn(out,unitStrIds);
 }
 
 
 
 /**************************************************************************/
 DataItemsDB::DataItemsDB(const QString& fn,QChar splitChar,
-                         DatasetInfos *datasetInfos,EventsDB *eventsDB)
-  : datasetInfosPtr(datasetInfos),eventsDBPtr(eventsDB)
+                         DatasetInfos *datasetInfos,EventsDB *eventsDB,
+                         int chunkLineCount,int workerThreadCount)
+  : datasetInfosPtr(datasetInfos),eventsDBPtr(eventsDB),
+    chunkLines(qMax(1,chunkLineCount))
 /**************************************************************************/
 /*!
 
   \brief Creates a DataItemsDB object and loads the data items from
   file \a fn.
 
+  The file is read in chunks of \a chunkLineCount lines (see
+  streamFile()). Parsing and filtering uses \a workerThreadCount
+  threads. If \a workerThreadCount is 0, \a idpThreadCount is used,
+  or the number of processor cores, if this is 0 as well.
+
   Only data items with PI permission and S&I approval and not removed
   are kept.
 
 */
 {
-  QStringList sl=fileContents(fn),vals; DataItem di;
-  columnLabels=columnLabelsFromHeader(sl.at(0),splitChar);
+  hasSubSampleIdxs=false;
+  threadCount=::workerThreadCount(workerThreadCount);
 
-  idxEventNumber=columnLabels.indexOf("BODC_EVENT_NUMBER");
-  idxBottleNumber=columnLabels.indexOf("BODC_BOTTLE_NUMBER");
-  idxRosetteBottleNumber=columnLabels.indexOf("ROSETTE_BOTTLE_NUMBER");
-  idxBottleFlag=columnLabels.indexOf("BODC_BOTTLE_FLAG");
-  idxcellSampleId=columnLabels.indexOf("SAMPLE_CELL_ID");
-  idxSubSampleId=columnLabels.indexOf("SUB_SAMPLE_NUMBER");
-  idxGeotracesSampleId=columnLabels.indexOf("GEOTRACES_SAMPLE_ID");
-  idxDepth=columnLabels.indexOf("DEPTH");
-  idxPressure=columnLabels.indexOf("PRESSURE");
-  idxParameter=columnLabels.indexOf("PARAMETER");
-  idxParameterValue=columnLabels.indexOf("PARAMETER_VALUE");
-  idxParameterStDev=columnLabels.indexOf("1SD::PARAMETER_VALUE");
-  idxFlag=columnLabels.indexOf("FLAG");
-  idxUnits=columnLabels.indexOf("UNIT");
+  streamFile(fn,splitChar);
+}
 
-  appendItems(sl,splitChar);
+/**************************************************************************/
+DataItemsDB::DataItemsDB(QDataStream& in,
+                         DatasetInfos *datasetInfos,EventsDB *eventsDB,
+                         int workerThreadCount)
+  : datasetInfosPtr(datasetInfos),eventsDBPtr(eventsDB),chunkLines(100000)
+/**************************************************************************/
+/*!
+
+  \brief Creates a DataItemsDB object and reads the data items and
+  bookkeeping information from binary stream \a in (see writeTo()).
+
+  The strings referenced by the data items are added to the global
+  string pool.
+
+*/
+{
+  hasSubSampleIdxs=false;
+  threadCount=::workerThreadCount(workerThreadCount);
+
+  QStringList labels; in >> labels; setColumnLabels(labels);
+  QVector<int> strIdMap=RStringPool::global().internFrom(in);
+  readFrom(in,strIdMap);
+
+  in >> multiSubSampleItems >> acceptedCruises >> acceptedPrmNames
+     >> acceptedExtPrmNames >> errMsgs;
 }
 
 /**************************************************************************/
@@ -157,50 +615,49 @@ void DataItemsDB::aggregateSubSamples()
   the contributing values
 
   The data items of all other subsamples (2 or higher) are removed from
-  this DataItemsDB.
+  this DataItemsDB in a single compaction pass.
 
 */
 {
   /* create multi_subsample_data_lines summary */
   QStringList subSampleKeys=multiSubSampleItems.keys();
   int i,j,m=subSampleKeys.size(),valueCount,idx0; QList<int> idxs;
-  QVector<double> vals; QList<char> qfs; DataItem di0;
+  QVector<double> vals; QList<char> qfs; QVector<bool> isRemoved(size(),false);
+  bool hasRemovals=false;
   for (i=0; i<m; ++i)
     {
       idxs=dataItemIndexes(subSampleKeys.at(i));
       if (idxs.size()>1)
         {
-          idx0=idxs.at(0); di0=at(idx0);
+          idx0=idxs.at(0);
 
           /* obtain median value and poorest quality flag */
           vals.clear(); qfs.clear();
           for (j=0; j<idxs.size(); ++j)
             {
-              vals.append(at(idxs.at(j)).parameterValue);
-              qfs.append(at(idxs.at(j)).flag);
+              vals.append(parameterValues.at(idxs.at(j)));
+              qfs.append(flags.at(idxs.at(j)));
             }
 
           /* obtain median value and poorest quality flag */
           valueCount=vals.size();
           if (valueCount>1)
             {
+              /* update data item at idx0 */
               RRandomVar rv(valueCount,vals.data(),ODV::missDOUBLE);
-              di0.parameterValue=rv.median();
-              di0.standardDevValue=ODV::missDOUBLE;
-              di0.flag=combinedSdnQualityFlag(qfs);
+              parameterValues[idx0]=rv.median();
+              standardDevValues[idx0]=ODV::missDOUBLE;
+              flags[idx0]=combinedSdnQualityFlag(qfs);
             }
 
-          /* update data item at idx0 */
-          replace(idx0,di0);
-
-          /* remove the other subsample data items, reverse order */
-          for (j=(idxs.size()-1); j>0; --j)
-            removeAt(idxs.at(j));
+          /* mark the other subsample data items for removal */
+          for (j=1; j<idxs.size(); ++j)
+            { isRemoved[idxs.at(j)]=true; hasRemovals=true; }
         }
     }
 
-    /* clear the subsample list */
-    subSampleKeys.clear();
+  /* remove all marked data items at once */
+  if (hasRemovals) { removeMarked(isRemoved); invalidateSubSampleIndex(); }
 }
 
 /**************************************************************************/
@@ -216,66 +673,27 @@ void DataItemsDB::appendFile(const QString& fn,QChar splitChar)
 
 */
 {
-  QStringList sl=fileContents(fn),vals; DataItem di;
-  if (columnLabels!=columnLabelsFromHeader(sl.at(0),splitChar)) return;
-
-  appendItems(sl,splitChar);
+  streamFile(fn,splitChar);
 }
 
 /**************************************************************************/
-void DataItemsDB::appendItems(const QStringList& lines,QChar splitChar)
+void DataItemsDB::appendItems(const QStringList& lines,QChar splitChar,
+                              int firstLine)
 /**************************************************************************/
 /*!
 
-  \brief Extracts the data items from string list \a lines and appends
-  these to this object.
+  \brief Extracts the data items from string list \a lines, starting
+  at index \a firstLine, and appends these to this object.
 
   Only data items with PI permission and S&I approval and not removed
   are kept.
 
 */
 {
-  int i,lineCount=lines.size(); bool isApproved,isRemoved; DataItem di;
-  QString prmName,extPrmName,cruise,cruiseFromEvents,geotracesCruise,s;
-  RTableRow datasetRTableRow,eventRTableRow;
-  for (i=1; i<lineCount; ++i)
-    {
-      di=DataItem(this,lines.at(i),splitChar);
-      extPrmName=di.parameter;
-      eventRTableRow=eventsDBPtr->value(QString::number(di.eventNumber));
-      datasetRTableRow=datasetInfosPtr->value(extPrmName);
-
-      if (datasetRTableRow.isEmpty())
-        {
-          errMsgs.insert(QString("DataItemsDB::Dataset not found %1").arg(extPrmName),1);
-          continue;
-        }
-
-      cruise=datasetRTableRow.at(datasetInfosPtr->idxCruise);
-      cruiseFromEvents=eventRTableRow.at(0);
-      geotracesCruise=datasetInfosPtr->geotracesCruiseNameFor(cruise);
-      prmName=Param::paramNameFromExtendedName(extPrmName);
-      isApproved=datasetInfosPtr->hasApprovalsForExtendedParamName(extPrmName);
-      isRemoved=datasetInfosPtr->isRemovedDataset(cruise,prmName);
-
-      if (di.subSampleNumber>1)
-        multiSubSampleItems.insert(QString("%1\t%2").arg(di.bodcBottleNumber).arg(di.parameter),1);
-
-      if (cruise!=cruiseFromEvents)
-        {
-          errMsgs.insert(QString("DataItemsDB::CruiseMismatch(%1,%2) event#: %3 %4")
-            .arg(cruise).arg(cruiseFromEvents)
-            .arg(di.eventNumber).arg(di.parameter),1);
-        }
-
-      /* skip if not approved or removed */
-      if (!isApproved || isRemoved) continue;
-
-      append(di);
-      acceptedCruises.insert(cruise,geotracesCruise);
-      acceptedPrmNames.insert(prmName,1);
-      acceptedExtPrmNames.insert(extPrmName,1);
-    }
+  int i,lineCount=lines.size(); DataItemBatch batch;
+  for (i=firstLine; i<lineCount; ++i)
+    filterItem(DataItem(this,lines.at(i),splitChar),batch);
+  mergeBatch(batch);
 }
 
 /**************************************************************************/
@@ -307,20 +725,343 @@ QList<int> DataItemsDB::dataItemIndexes(const QString& sampleKey)
 Sample keys consist of the BODC_BOTTLE_NUMBER and PARAMETER values
 separated by TAB.
 
+The keys in \a multiSubSampleItems are looked up in the sub-sample
+index (see buildSubSampleIndex()). All other keys require a full scan.
+
 \return The determined index list.
 
 */
 {
-  QStringList sl=sampleKey.split("\t"); QString prm=sl.at(1); DataItem di;
-  QList<int> idxs; int i,n=size(),bn=sl.at(0).toInt();
+  QPair<int,int> key=subSampleKeyIds(sampleKey);
+  QList<int> idxs; int i,n=size(),bn=key.first,prmId=key.second;
+  if (prmId==-1) return idxs;
+
+  if (!hasSubSampleIdxs) buildSubSampleIndex();
+  if (subSampleIdxs.contains(key)) return subSampleIdxs.value(key);
 
+  const int *bns=bodcBottleNumbers.constData();
+  const int *prmIds=parameterStrIds.constData();
   for (i=0; i<n; ++i)
+    if (bns[i]==bn && prmIds[i]==prmId)  idxs << i;
+
+  return idxs;
+}
+
+/**************************************************************************/
+void DataItemsDB::buildSubSampleIndex()
+/**************************************************************************/
+/*!
+
+  \brief Builds the index lists of all (BODC bottle number, parameter)
+  keys in \a multiSubSampleItems in a single pass over all data items.
+
+*/
+{
+  subSampleIdxs.clear();
+
+  QMap<QString,int>::ConstIterator it; QPair<int,int> key;
+  for (it=multiSubSampleItems.constBegin();
+       it!=multiSubSampleItems.constEnd(); ++it)
     {
-      di=at(i);
-      if (di.bodcBottleNumber==bn && di.parameter==prm)  idxs << i;
+      key=subSampleKeyIds(it.key());
+      if (key.second>-1) subSampleIdxs.insert(key,QList<int>());
     }
 
-  return idxs;
+  int i,n=size();
+  const int *bns=bodcBottleNumbers.constData();
+  const int *prmIds=parameterStrIds.constData();
+  QHash<QPair<int,int>,QList<int> >::Iterator iti;
+  for (i=0; i<n && !subSampleIdxs.isEmpty(); ++i)
+    {
+      iti=subSampleIdxs.find(QPair<int,int>(bns[i],prmIds[i]));
+      if (iti!=subSampleIdxs.end()) iti.value().append(i);
+    }
+
+  hasSubSampleIdxs=true;
+}
+
+/**************************************************************************/
+void DataItemsDB::invalidateSubSampleIndex()
+/**************************************************************************/
+/*!
+
+  \brief Discards the sub-sample index. It is rebuilt on next use.
+
+*/
+{
+  subSampleIdxs.clear(); hasSubSampleIdxs=false;
+}
+
+/**************************************************************************/
+QPair<int,int> DataItemsDB::subSampleKeyIds(const QString& sampleKey)
+/**************************************************************************/
+/*!
+
+  \brief Converts sample key \a sampleKey (BODC_BOTTLE_NUMBER and
+  PARAMETER separated by TAB) to BODC bottle number and parameter
+  string ID.
+
+  \return The BODC bottle number (first) and parameter string ID
+  (second). The string ID is \c -1 if the parameter is unknown.
+
+*/
+{
+  QStringList sl=sampleKey.split("\t");
+  return QPair<int,int>(sl.at(0).toInt(),
+                        RStringPool::global().idOf(sl.value(1)));
+}
+
+/**************************************************************************/
+void DataItemsDB::filterItem(const DataItem& di,DataItemBatch& batch) const
+/**************************************************************************/
+/*!
+
+  \brief Appends data item \a di to \a batch, if the item has PI
+  permission and S&I approval and is not removed.
+
+  Cruise mismatches and unknown datasets are recorded in the error
+  messages of \a batch. Dataset and event lookups are cached in \a
+  batch by extended parameter name ID and event number. This function
+  only reads shared data and may be called concurrently for different
+  batches.
+
+*/
+{
+  const QString& extPrmName=di.parameter();
+
+  if (!batch.filterInfos.contains(di.parameterStrId))
+    batch.filterInfos.insert(di.parameterStrId,filterInfoFor(extPrmName));
+  const DataItemFilterInfo& fi=batch.filterInfos[di.parameterStrId];
+
+  if (!fi.hasDataset)
+    {
+      batch.errMsgs.insert(QString("DataItemsDB::Dataset not found %1").arg(extPrmName),1);
+      return;
+    }
+
+  if (!batch.cruisesByEvent.contains(di.eventNumber))
+    batch.cruisesByEvent.insert(di.eventNumber,
+                                eventsDBPtr->rowOf(di.eventNumber).value(0));
+  const QString& cruiseFromEvents=batch.cruisesByEvent[di.eventNumber];
+
+  if (di.subSampleNumber>1)
+    batch.multiSubSampleItems.insert(QString("%1\t%2").arg(di.bodcBottleNumber).arg(extPrmName),1);
+
+  if (fi.cruise!=cruiseFromEvents)
+    {
+      batch.errMsgs.insert(QString("DataItemsDB::CruiseMismatch(%1,%2) event#: %3 %4")
+        .arg(fi.cruise).arg(cruiseFromEvents)
+        .arg(di.eventNumber).arg(extPrmName),1);
+    }
+
+  /* skip if not approved or removed */
+  if (!fi.isAccepted) return;
+
+  batch.items.append(di);
+  batch.acceptedCruises.insert(fi.cruise,fi.geotracesCruise);
+  batch.acceptedPrmNames.insert(fi.prmName,1);
+  batch.acceptedExtPrmNames.insert(extPrmName,1);
+}
+
+/**************************************************************************/
+DataItemFilterInfo DataItemsDB::filterInfoFor(const QString& extPrmName) const
+/**************************************************************************/
+/*!
+
+  \brief Looks up the dataset related information for extended
+  parameter name \a extPrmName.
+
+  \return The retrieved information.
+
+*/
+{
+  DataItemFilterInfo fi;
+  RTableRow datasetRTableRow=datasetInfosPtr->value(extPrmName);
+  fi.hasDataset=!datasetRTableRow.isEmpty();
+  if (!fi.hasDataset) return fi;
+
+  fi.cruise=datasetRTableRow.at(datasetInfosPtr->idxCruise);
+  fi.geotracesCruise=datasetInfosPtr->geotracesCruiseNameFor(fi.cruise);
+  fi.prmName=Param::paramNameFromExtendedName(extPrmName);
+  fi.isAccepted=datasetInfosPtr->hasApprovalsForExtendedParamName(extPrmName) &&
+    !datasetInfosPtr->isRemovedDataset(fi.cruise,fi.prmName);
+  return fi;
+}
+
+/**************************************************************************/
+void DataItemsDB::mergeBatch(const DataItemBatch& batch)
+/**************************************************************************/
+/*!
+
+  \brief Appends the data items of \a batch to this object and merges
+  the bookkeeping maps of \a batch into the maps of this object.
+
+*/
+{
+  append(batch.items); invalidateSubSampleIndex();
+
+  QMap<QString,int>::ConstIterator it;
+  for (it=batch.multiSubSampleItems.constBegin();
+       it!=batch.multiSubSampleItems.constEnd(); ++it)
+    multiSubSampleItems.insert(it.key(),it.value());
+  for (it=batch.acceptedPrmNames.constBegin();
+       it!=batch.acceptedPrmNames.constEnd(); ++it)
+    acceptedPrmNames.insert(it.key(),it.value());
+  for (it=batch.acceptedExtPrmNames.constBegin();
+       it!=batch.acceptedExtPrmNames.constEnd(); ++it)
+    acceptedExtPrmNames.insert(it.key(),it.value());
+  for (it=batch.errMsgs.constBegin(); it!=batch.errMsgs.constEnd(); ++it)
+    errMsgs.insert(it.key(),it.value());
+
+  QMap<QString,QString>::ConstIterator itc;
+  for (itc=batch.acceptedCruises.constBegin();
+       itc!=batch.acceptedCruises.constEnd(); ++itc)
+    acceptedCruises.insert(itc.key(),itc.value());
+}
+
+/**************************************************************************/
+void DataItemsDB::setColumnLabels(const QStringList& labels)
+/**************************************************************************/
+/*!
+
+  \brief Sets the column labels to \a labels and determines the
+  indexes of all required columns.
+
+*/
+{
+  columnLabels=labels;
+
+  idxEventNumber=columnLabels.indexOf("BODC_EVENT_NUMBER");
+  idxBottleNumber=columnLabels.indexOf("BODC_BOTTLE_NUMBER");
+  idxRosetteBottleNumber=columnLabels.indexOf("ROSETTE_BOTTLE_NUMBER");
+  idxBottleFlag=columnLabels.indexOf("BODC_BOTTLE_FLAG");
+  idxcellSampleId=columnLabels.indexOf("SAMPLE_CELL_ID");
+  idxSubSampleId=columnLabels.indexOf("SUB_SAMPLE_NUMBER");
+  idxGeotracesSampleId=columnLabels.indexOf("GEOTRACES_SAMPLE_ID");
+  idxDepth=columnLabels.indexOf("DEPTH");
+  idxPressure=columnLabels.indexOf("PRESSURE");
+  idxParameter=columnLabels.indexOf("PARAMETER");
+  idxParameterValue=columnLabels.indexOf("PARAMETER_VALUE");
+  idxParameterStDev=columnLabels.indexOf("1SD::PARAMETER_VALUE");
+  idxFlag=columnLabels.indexOf("FLAG");
+  idxUnits=columnLabels.indexOf("UNIT");
+}
+
+/**************************************************************************/
+bool DataItemsDB::streamFile(const QString& fn,QChar splitChar)
+/**************************************************************************/
+/*!
+
+  \brief Reads the data items from file \a fn in chunks of \a
+  chunkLines lines and appends the accepted ones to this object.
+
+  Each chunk is parsed and filtered (approval, removal, cruise
+  mismatch) by appendItems() and then discarded, so that the raw text
+  of at most one chunk is held in memory at any time.
+
+  The column labels are taken from the header line of the first file
+  loaded. The header line of any subsequent file must be identical,
+  otherwise the file is ignored.
+
+  The memory mapped tokenizer path (see streamMappedFile()) is tried
+  first. The chunked text stream path is only used if the file cannot
+  be mapped.
+
+  \return \c true if successful, or \c false otherwise.
+
+*/
+{
+  RCsvTokenizer tok(fn,splitChar.toLatin1());
+  if (tok.isOpen()) return streamMappedFile(tok,splitChar);
+
+  QFile fi(fn);
+  if (!fi.exists() || !fi.open(QFile::ReadOnly)) return false;
+
+  QTextStream in(&fi); in.setCodec("UTF-8");
+  if (in.atEnd()) return false;
+
+  /* set up or verify the column labels */
+  QStringList labels=columnLabelsFromHeader(in.readLine(),splitChar);
+  if      (columnLabels.isEmpty()) setColumnLabels(labels);
+  else if (labels!=columnLabels)   return false;
+
+  /* read, parse and discard the data lines chunk by chunk */
+  QStringList chunk; chunk.reserve(chunkLines);
+  while (!in.atEnd())
+    {
+      chunk << in.readLine();
+      if (chunk.size()>=chunkLines)
+        { appendItems(chunk,splitChar,0); chunk.clear(); }
+    }
+  appendItems(chunk,splitChar,0);
+
+  return true;
+}
+
+/**************************************************************************/
+bool DataItemsDB::streamMappedFile(const RCsvTokenizer& tok,QChar splitChar)
+/**************************************************************************/
+/*!
+
+  \brief Reads the data items from the file mapped by tokenizer \a
+  tok and appends the accepted ones to this object.
+
+  Lines are split into column values in place. Only the string valued
+  columns of a data item are converted to QString, all numeric values
+  are parsed directly from the mapped buffer.
+
+  The data lines are partitioned into byte ranges starting at line
+  boundaries. The ranges are parsed and filtered concurrently by \a
+  threadCount worker threads into separate DataItemBatch objects,
+  which are then merged in original line order. The result is
+  identical to serial processing.
+
+  \return \c true if successful, or \c false otherwise.
+
+*/
+{
+  qint64 pos=tok.firstLinePos(),endPos=tok.byteSize();
+  RCsvField line;
+  if (!tok.nextLine(pos,endPos,line)) return false;
+
+  /* set up or verify the column labels */
+  QStringList labels=columnLabelsFromHeader(line.toString(),splitChar);
+  if      (columnLabels.isEmpty()) setColumnLabels(labels);
+  else if (labels!=columnLabels)   return false;
+
+  /* partition the data lines into byte ranges; small files are
+     processed in a single range */
+  const qint64 minRangeSize=1<<20;
+  qint64 byteCount=endPos-pos;
+  int i,rangeCount=(int) qMin((qint64) 4*threadCount,
+                              qMax((qint64) 1,byteCount/minRangeSize));
+  QVector<qint64> starts(rangeCount+1);
+  starts[0]=pos; starts[rangeCount]=endPos;
+  for (i=1; i<rangeCount; ++i)
+    starts[i]=qMax(starts.at(i-1),
+                   tok.lineStartAtOrAfter(pos+(byteCount*i)/rangeCount));
+
+  /* parse and filter all ranges */
+  QVector<DataItemBatch> batches(rangeCount);
+  QList<DataItemsWorker*> workers;
+  for (i=0; i<rangeCount; ++i)
+    workers << new DataItemsWorker(this,&tok,starts.at(i),starts.at(i+1),
+                                   &batches[i]);
+  if (rangeCount==1)
+    workers.at(0)->run();
+  else
+    {
+      QThreadPool pool; pool.setMaxThreadCount(threadCount);
+      for (i=0; i<rangeCount; ++i) pool.start(workers.at(i));
+      pool.waitForDone();
+    }
+  qDeleteAll(workers);
+
+  /* merge the batches in original order */
+  for (i=0; i<rangeCount; ++i)
+    { mergeBatch(batches.at(i)); batches[i]=DataItemBatch(); }
+
+  return true;
 }
 
 /**************************************************************************/
@@ -387,6 +1128,27 @@ void DataItemsDB::writeDiagnostics(CruisesDB *cruisesDBPtr)
   appendRecords(dir+"DataItemsDB_accepted_cruises_full.txt",sl,true);
 }
 
+/**************************************************************************/
+void DataItemsDB::writeTo(QDataStream& out) const
+/**************************************************************************/
+/*!
+
+  \brief Writes the data items and bookkeeping information to binary
+  stream \a out.
+
+  The global string pool is written as well, so that string IDs can be
+  translated when reading.
+
+*/
+{
+  out << columnLabels;
+  RStringPool::global().writeTo(out);
+  DataItemStore::writeTo(out);
+
+  out << multiSubSampleItems << acceptedCruises << acceptedPrmNames
+      << acceptedExtPrmNames << errMsgs;
+}
+
 
 
 /**************************************************************************/
@@ -400,15 +1162,17 @@ DataItemList::DataItemList(IdpDataType dataType,
 
 */
 {
-  QList<int> idxs; int i,k,dataItemCount=dataItemsDBPtr->size();
-  QString prmName,extPrmName,cruise,geotracesCruise;
-  DataItem di; RTableRow datasetRTableRow; IdpDataType dType;
+  int i,k,prmStrId,dataItemCount=dataItemsDBPtr->size();
+  QString prmName; IdpDataType dType;
+  QHash<int,ExtendedNameInfo> nameInfosByStrId;
 
   for (i=0; i<dataItemCount; ++i)
     {
-      di=dataItemsDBPtr->at(i);
-      prmName=Param::paramNameFromExtendedName(di.parameter);
-      dType=Param::dataType(prmName);
+      DataItemView di=dataItemsDBPtr->row(i); prmStrId=di.parameterStrId();
+      if (!nameInfosByStrId.contains(prmStrId))
+        nameInfosByStrId.insert(prmStrId,Param::extendedNameInfo(di.parameter()));
+      const ExtendedNameInfo& ei=nameInfosByStrId[prmStrId];
+      prmName=ei.name; dType=ei.dataType;
 
       /* skip if wrong data type */
       if (dType!=type)
@@ -419,13 +1183,32 @@ DataItemList::DataItemList(IdpDataType dataType,
         }
 
       idxIntoDataItemDB.append(i);
-      acceptedEventNumbers.insert(QString::number(di.eventNumber),1);
+      acceptedEventNumbers.insert(di.eventNumber());
       acceptedPrmNames.insert(prmName,1);
-      acceptedExtPrmNames.insert(di.parameter,1);
+      acceptedExtPrmNames.insert(di.parameter(),1);
     }
   buildIndexListsByEventNumber();
 }
 
+/**************************************************************************/
+QVector<int> DataItemList::acceptedEventNumberList() const
+/**************************************************************************/
+/*!
+
+  \brief \return The accepted event numbers, sorted by their decimal
+  strings (not numerically), which is the order in which the stations
+  are collated.
+
+*/
+{
+  QVector<int> evtNums; evtNums.reserve(acceptedEventNumbers.size());
+  QSet<int>::ConstIterator it;
+  for (it=acceptedEventNumbers.constBegin(); it!=acceptedEventNumbers.constEnd(); ++it)
+    evtNums.append(*it);
+  std::sort(evtNums.begin(),evtNums.end(),decimalStringLessThan);
+  return evtNums;
+}
+
 /**************************************************************************/
 void DataItemList::buildIndexListsByEventNumber()
 /**************************************************************************/
@@ -441,7 +1224,7 @@ void DataItemList::buildIndexListsByEventNumber()
   for (i=0; i<n; ++i)
     {
       idx=idxIntoDataItemDB.at(i);
-      evtNum=itemAt(idx).eventNumber;
+      evtNum=dataItemsDBPtr->eventNumbers.at(idx);
 
       if (dataIdxsByEvent.contains(evtNum))
         idxs=dataIdxsByEvent.value(evtNum);
@@ -453,17 +1236,17 @@ void DataItemList::buildIndexListsByEventNumber()
 }
 
 /**************************************************************************/
-DataItem DataItemList::itemAt(int idx)
+DataItemView DataItemList::itemAt(int idx) const
 /**************************************************************************/
 /*!
 
-  \brief Retrieves the DataItem object at index \a idx.
+  \brief Retrieves a view of the data item at index \a idx.
 
-  \return The retrieved DataItem object.
+  \return The retrieved DataItemView object.
 
 */
 {
-  return dataItemsDBPtr->at(idx);
+  return dataItemsDBPtr->row(idx);
 }
 
 /**************************************************************************/
@@ -478,16 +1261,16 @@ void DataItemList::validateUnits(ParamSet *paramSet)
 {
   const QString fmt="Bad units: %1 [%2] should be [%3]";
   QMap<QString,int> bu; int i,idx,n=idxIntoDataItemDB.size();
-  QString prmUnits,trgUnits; DataItem di;
+  QString prmUnits,trgUnits;
   for (i=0; i<n; ++i)
     {
       idx=idxIntoDataItemDB.at(i);
-      di=dataItemsDBPtr->at(idx); prmUnits=di.unit;
+      DataItemView di=dataItemsDBPtr->row(idx); prmUnits=di.unit();
       if (prmUnits=="dimensionless") prmUnits=QString();
-      trgUnits=paramSet->paramUnitsOf(Param::paramNameFromExtendedName(di.parameter));
+      trgUnits=paramSet->paramUnitsOf(Param::paramNameFromExtendedName(di.parameter()));
       if (trgUnits=="unknown_units") continue;
       if (trgUnits!=prmUnits)
-        bu.insert(fmt.arg(di.parameter).arg(di.unit).arg(trgUnits),1);
+        bu.insert(fmt.arg(di.parameter()).arg(di.unit()).arg(trgUnits),1);
     }
 
   QDir().mkpath(idpErrorsDir);
@@ -540,13 +1323,13 @@ void DataItemList::writeSamplingSystems(const QString fn,EventsDB *eventsDB)
   QString prmName,smplSys; ParamSamplingSystem ss; QStringList sl,pl;
   QMap<QString,QList<QPair<QString,int> > > smplSystemByPrm,smplSystemBySmplSys;
 
-  DataItem di; EventInfo ei;
+  EventInfo ei;
   for (i=0; i<n; ++i)
     {
-      idx=idxIntoDataItemDB.at(i); di=dataItemsDBPtr->at(idx);
-      prmName=Param::paramNameFromExtendedName(di.parameter);
-      ss=Param::samplingSystem(prmName); smplSys=Param::samplingSystemStr(ss);
-      ei=eventsDB->eventInfoOf(QString::number(di.eventNumber));
+      idx=idxIntoDataItemDB.at(i); DataItemView di=dataItemsDBPtr->row(idx);
+      ExtendedNameInfo eni=Param::extendedNameInfo(di.parameter());
+      prmName=eni.name; ss=eni.samplingSystem; smplSys=eni.samplingSuffix;
+      ei=eventsDB->eventInfoOf(di.eventNumber());
 
       updateSampleDeviceCounts(smplSystemByPrm,prmName,ei.samplingDevice);
       updateSampleDeviceCounts(smplSystemBySmplSys,smplSys,ei.samplingDevice);
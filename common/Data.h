@@ -10,16 +10,23 @@
 **
 ****************************************************************************/
 
+#include <QHash>
 #include <QList>
 #include <QMap>
+#include <QPair>
+#include <QSet>
 #include <QString>
 #include <QStringList>
+#include <QVector>
 
 #include "globalDefines.h"
+#include "RCsvTokenizer.h"
+#include "RStringPool.h"
 #include "RTable.h"
 
 class CruisesDB;
 class DataItemsDB;
+class DataItemView;
 class DatasetInfos;
 class EventsDB;
 class ParamSet;
@@ -34,30 +41,177 @@ class DataItem
 */
 {
 public:
-  DataItem() { eventNumber=-1; }
+  DataItem() : eventNumber(-1),geotracesSampleStrId(0),cellSampleStrId(0),
+    parameterStrId(0),unitStrId(0) { }
   DataItem(DataItemsDB *dataItemDB,const QString& line,QChar splitChar);
+  DataItem(DataItemsDB *dataItemDB,QVector<RCsvField>& fields);
 
+  void completeDepthPressure();
+  const QString& cellSampleId() const
+  { return RStringPool::global().string(cellSampleStrId); }
+  const QString& geotracesSampleId() const
+  { return RStringPool::global().string(geotracesSampleStrId); }
+  const QString& parameter() const
+  { return RStringPool::global().string(parameterStrId); }
   int paramId(ParamSet *paramSet);
   QString toString(QChar sepChar=',') const;
+  const QString& unit() const
+  { return RStringPool::global().string(unitStrId); }
 
   int eventNumber;
   int bodcBottleNumber;
   int rosetteBottleNumber;
   int subSampleNumber;
-  QString geotracesSampleId;
-  QString cellSampleId;
+  int geotracesSampleStrId; //!< string pool ID of GEOTRACES sample ID
+  int cellSampleStrId;      //!< string pool ID of cell sample ID
   char bodcBottleFlag;
   double depth;
   double pressure;
-  QString parameter;
+  int parameterStrId;       //!< string pool ID of extended parameter name
   double parameterValue;
   double standardDevValue;
   char flag;
-  QString unit;
+  int unitStrId;            //!< string pool ID of units
 };
 
 /**************************************************************************/
-class DataItemsDB : public QList<DataItem>
+class DataItemStore
+/**************************************************************************/
+/*!
+
+  \brief Column oriented container of data items.
+
+  Every data item field is held in its own contiguous array. String
+  fields are held as RStringPool IDs. Use row() to access the fields
+  of one item without copying, and at() to obtain a DataItem copy.
+
+*/
+{
+public:
+  void append(const DataItem& di);
+  void append(const DataItemStore& other);
+  DataItem at(int idx) const;
+  void clear();
+  int count() const { return eventNumbers.size(); }
+  bool readFrom(QDataStream& in,const QVector<int>& strIdMap);
+  void removeAt(int idx);
+  void removeMarked(const QVector<bool>& isRemoved);
+  void replace(int idx,const DataItem& di);
+  void reserve(int n);
+  inline DataItemView row(int idx) const;
+  int size() const { return eventNumbers.size(); }
+  void writeTo(QDataStream& out) const;
+
+  QVector<int> eventNumbers;          //!< event numbers
+  QVector<int> bodcBottleNumbers;     //!< BODC bottle numbers
+  QVector<int> rosetteBottleNumbers;  //!< rosette bottle numbers
+  QVector<int> subSampleNumbers;      //!< sub-sample numbers
+  QVector<int> geotracesSampleStrIds; //!< GEOTRACES sample ID string IDs
+  QVector<int> cellSampleStrIds;      //!< cell sample ID string IDs
+  QVector<char> bodcBottleFlags;      //!< BODC bottle flags
+  QVector<double> depths;             //!< depth values
+  QVector<double> pressures;          //!< pressure values
+  QVector<int> parameterStrIds;       //!< extended parameter name string IDs
+  QVector<double> parameterValues;    //!< parameter values
+  QVector<double> standardDevValues;  //!< standard deviation values
+  QVector<char> flags;                //!< quality flags
+  QVector<int> unitStrIds;            //!< unit string IDs
+};
+
+/**************************************************************************/
+class DataItemView
+/**************************************************************************/
+/*!
+
+  \brief Read-only view of one data item in a DataItemStore.
+
+  The view does not copy any data. It remains valid as long as the
+  store is not modified.
+
+*/
+{
+public:
+  DataItemView(const DataItemStore *store,int idx) : s(store),i(idx) { }
+
+  char bodcBottleFlag() const { return s->bodcBottleFlags.at(i); }
+  int bodcBottleNumber() const { return s->bodcBottleNumbers.at(i); }
+  const QString& cellSampleId() const
+  { return RStringPool::global().string(s->cellSampleStrIds.at(i)); }
+  double depth() const { return s->depths.at(i); }
+  int eventNumber() const { return s->eventNumbers.at(i); }
+  char flag() const { return s->flags.at(i); }
+  const QString& geotracesSampleId() const
+  { return RStringPool::global().string(s->geotracesSampleStrIds.at(i)); }
+  int index() const { return i; }
+  const QString& parameter() const
+  { return RStringPool::global().string(s->parameterStrIds.at(i)); }
+  int parameterStrId() const { return s->parameterStrIds.at(i); }
+  double parameterValue() const { return s->parameterValues.at(i); }
+  double pressure() const { return s->pressures.at(i); }
+  int rosetteBottleNumber() const { return s->rosetteBottleNumbers.at(i); }
+  double standardDevValue() const { return s->standardDevValues.at(i); }
+  int subSampleNumber() const { return s->subSampleNumbers.at(i); }
+  DataItem toDataItem() const { return s->at(i); }
+  const QString& unit() const
+  { return RStringPool::global().string(s->unitStrIds.at(i)); }
+
+private:
+  const DataItemStore *s; //!< pointer to the store
+  int i;                  //!< row index into the store
+};
+
+inline DataItemView DataItemStore::row(int idx) const
+{ return DataItemView(this,idx); }
+
+/**************************************************************************/
+class DataItemFilterInfo
+/**************************************************************************/
+/*!
+
+  \brief Dataset related information for one extended parameter name,
+  as needed when filtering data items.
+
+*/
+{
+public:
+  DataItemFilterInfo() : hasDataset(false),isAccepted(false) { }
+
+  bool hasDataset;         //!< dataset exists for the extended name
+  bool isAccepted;         //!< has approvals and is not removed
+  QString cruise;          //!< cruise name of the dataset
+  QString geotracesCruise; //!< GEOTRACES cruise name of the dataset
+  QString prmName;         //!< parameter name
+};
+
+/**************************************************************************/
+class DataItemBatch
+/**************************************************************************/
+/*!
+
+  \brief Accepted data items and bookkeeping information obtained
+  from a contiguous range of input lines.
+
+  Used as thread-local result container during parallel ingest (see
+  DataItemsDB::streamMappedFile()).
+
+*/
+{
+public:
+  DataItemStore items;                   //!< accepted data items
+  QMap<QString,int> multiSubSampleItems; //!< see DataItemsDB
+  QMap<QString,QString> acceptedCruises; //!< see DataItemsDB
+  QMap<QString,int> acceptedPrmNames;    //!< see DataItemsDB
+  QMap<QString,int> acceptedExtPrmNames; //!< see DataItemsDB
+  QMap<QString,int> errMsgs;             //!< see DataItemsDB
+
+  QHash<int,DataItemFilterInfo> filterInfos;
+  //!< lookup cache: filter infos by extended parameter name string ID
+  QHash<int,QString> cruisesByEvent;
+  //!< lookup cache: cruise names by event number
+};
+
+/**************************************************************************/
+class DataItemsDB : public DataItemStore
 /**************************************************************************/
 /*!
 
@@ -67,13 +221,26 @@ class DataItemsDB : public QList<DataItem>
 {
 public:
   DataItemsDB(const QString& fn,QChar splitChar,
-              DatasetInfos *datasetInfos,EventsDB *eventsDB);
-              void appendFile(const QString& fn,QChar splitChar);
+              DatasetInfos *datasetInfos,EventsDB *eventsDB,
+              int chunkLineCount=100000,int workerThreadCount=0);
+  DataItemsDB(QDataStream& in,DatasetInfos *datasetInfos,EventsDB *eventsDB,
+              int workerThreadCount=0);
+  void appendFile(const QString& fn,QChar splitChar);
   void aggregateSubSamples();
-  void appendItems(const QStringList& lines,QChar splitChar);
+  void appendItems(const QStringList& lines,QChar splitChar,int firstLine=1);
+  void buildSubSampleIndex();
   static QStringList columnLabelsFromHeader(const QString& headerLine,QChar splitChar);
   QList<int> dataItemIndexes(const QString& sampleKey);
+  void filterItem(const DataItem& di,DataItemBatch& batch) const;
+  DataItemFilterInfo filterInfoFor(const QString& extPrmName) const;
+  void invalidateSubSampleIndex();
+  void mergeBatch(const DataItemBatch& batch);
+  void setColumnLabels(const QStringList& labels);
+  bool streamFile(const QString& fn,QChar splitChar);
+  bool streamMappedFile(const RCsvTokenizer& tok,QChar splitChar);
+  static QPair<int,int> subSampleKeyIds(const QString& sampleKey);
   void writeDiagnostics(CruisesDB *cruisesDBPtr);
+  void writeTo(QDataStream& out) const;
 
   int idxEventNumber,idxBottleNumber,idxRosetteBottleNumber,idxBottleFlag;
   int idxcellSampleId,idxSubSampleId,idxGeotracesSampleId,idxDepth,idxPressure;
@@ -82,7 +249,12 @@ public:
   DatasetInfos *datasetInfosPtr; //!< pointer to DOoR dataset infos
   EventsDB *eventsDBPtr;         //!< pointer to events database
   QStringList columnLabels;      //!< column header labels
+  int chunkLines;                //!< number of lines per chunk in streaming ingest
+  int threadCount;               //!< number of worker threads in parallel ingest
   QMap<QString,int> multiSubSampleItems; //!< BODC_BOTTLE_NUMBER/PARAMETER with sub-sample Id > 1
+  QHash<QPair<int,int>,QList<int> > subSampleIdxs;
+  //!< data item indexes by BODC bottle number and parameter string ID for multiSubSampleItems keys
+  bool hasSubSampleIdxs;         //!< subSampleIdxs is up to date
 
   QMap<QString,QString> acceptedCruises;
   //!< accepted GEOTRACES IDs (value) by cruise names (keys)
@@ -104,10 +276,11 @@ class DataItemList
 public:
   DataItemList(IdpDataType dataType,
                DataItemsDB *dataItemsDB,DatasetInfos *datasetInfos);
+  QVector<int> acceptedEventNumberList() const;
   void buildIndexListsByEventNumber();
   bool hasDataFor(const QString& prmName)
   { return dataItemsDBPtr->acceptedPrmNames.contains(prmName); }
-  DataItem itemAt(int idx);
+  DataItemView itemAt(int idx) const;
   void validateUnits(ParamSet *paramSet);
   void updateSampleDeviceCounts(QMap<QString,QList<QPair<QString,int> > >& smplDevs,
                                 const QString& key,const QString& smplDev);
@@ -122,7 +295,7 @@ public:
   //!< data index values (into dataItemsDBPtr) by event number (key)
   QMap<QString,QString> acceptedCruises;
   //!< accepted GEOTRACES IDs (value) by cruise names (keys) for this data type
-  QMap<QString,int> acceptedEventNumbers;
+  QSet<int> acceptedEventNumbers;
   //!< accepted event numbers for this data type
   QMap<QString,int> acceptedPrmNames;
   //!< accepted parameter names for this data type
@@ -9,6 +9,7 @@
 
 #include "Datasets.h"
 
+#include <QDataStream>
 #include <QDir>
 
 #include "globalVars.h"
@@ -32,16 +33,8 @@ entries from file \a fn.
 
 */
 {
-  /* determine various column indexes */
-  idxCruise=columnIndexOf("CRUISE");
-  idxGeotracesCruise=columnIndexOf("GEOTRACES CRUISE");
-  idxPrmBarcode=columnIndexOf("PARAMETER::BARCODE");
-  idxGdacDatasetId=columnIndexOf("GDAC DATASET ID");
-  idxSiApproval=columnIndexOf("S&I STATUS");
-  idxPiPermission=columnIndexOf("PERMISSION");
-  idxDataGenerator=columnIndexOf("DATA GENERATOR(S)");
-  idxAuthorisedScientist=columnIndexOf("AUTORISED SCIENTIST");
-  idxIdpVersion=columnIndexOf("IDP Version");
+  compileIgnoredDatasets();
+  setColumnIndexes();
 
   QMap<QString,RTableRow>::ConstIterator it; RTableRow ii;
   QString extPrmName,prmName,uPrmName,cruise,gtCruise,resolvedPrmName,resolvedUPrmName;
@@ -54,8 +47,8 @@ entries from file \a fn.
     {
       extPrmName=it.key(); ii=it.value();
       cruise=ii.at(idxCruise);
-      prmName=extPrmName.split("::").at(0);
-      uPrmName=Param::unifiedNameLabel(prmName,smplSuffix);
+      ExtendedNameInfo ei=Param::extendedNameInfo(extPrmName);
+      prmName=ei.name; uPrmName=ei.unifiedName; smplSuffix=ei.samplingSuffix;
       resolvedPrmName=prmName+" @ "+cruise;
       resolvedUPrmName=uPrmName+" @ "+cruise;
       gtCruise=ii.at(idxGeotracesCruise);
@@ -141,6 +134,58 @@ entries from file \a fn.
   appendRecords(dir+"Accepted_Parameter_Names.txt",prmNamesAccepted.keys(),true);
 }
 
+/**************************************************************************/
+DatasetInfos::DatasetInfos(QDataStream& in,QStringList *ignoredDatasets)
+: RTable(in),ignoredDatasetsPtr(ignoredDatasets)
+/**************************************************************************/
+/*!
+
+\brief Creates a DatasetInfos object and reads the DOoR dataset
+entries and the derived acceptance information from binary stream \a
+in (see writeTo()).
+
+No diagnostics files are written.
+
+*/
+{
+  compileIgnoredDatasets();
+  setColumnIndexes();
+
+  in >> acceptedPrmsByContribNames >> acceptedContribNamesByPrms
+     >> acceptedContribNamesByUPrms >> prmNamesAccepted
+     >> extPrmNamesSiApproved >> extPrmNamesPiApproved >> sectsByCruiseName;
+}
+
+/**************************************************************************/
+void DatasetInfos::compileIgnoredDatasets()
+/**************************************************************************/
+/*!
+
+\brief Compiles the ignored datasets list \a ignoredDatasetsPtr into
+the cruise keyed lookup table \a removedPrmsByCruise.
+
+The first line of the list is a header. All other lines have the form
+"cruise,parameter name", where parameter name "*" removes all
+parameters of the cruise. Lines with less than two fields are
+ignored.
+
+*/
+{
+  removedPrmsByCruise.clear();
+  if (!ignoredDatasetsPtr) return;
+
+  int i,n=ignoredDatasetsPtr->size(); QStringList sl;
+  for (i=1; i<n; ++i)
+    {
+      sl=ignoredDatasetsPtr->at(i).split(",");
+      if (sl.size()<2) continue;
+
+      RemovedParams& rp=removedPrmsByCruise[sl.at(0)];
+      if (sl.at(1)=="*") rp.isAllRemoved=true;
+      else               rp.prmNames.insert(sl.at(1));
+    }
+}
+
 /**************************************************************************/
 QString DatasetInfos::geotracesCruiseNameFor(const QString& cruise)
 /**************************************************************************/
@@ -188,7 +233,8 @@ approval and PI permission, or represents a _SENSOR parameter name.
 }
 
 /**************************************************************************/
-bool DatasetInfos::isRemovedDataset(const QString& cruise,const QString& prmName)
+bool DatasetInfos::isRemovedDataset(const QString& cruise,
+                                    const QString& prmName) const
 /**************************************************************************/
 /*!
 
@@ -196,19 +242,36 @@ bool DatasetInfos::isRemovedDataset(const QString& cruise,const QString& prmName
 cruise has been removed, e.g., is included in list \a
 ignoredDatasets.
 
+Uses the compiled list \a removedPrmsByCruise (see
+compileIgnoredDatasets()).
+
 \return \c true if the parameter is removed, or \c false otherwise.
 
 */
 {
-  int i,n=ignoredDatasetsPtr->size(); QString removedPrmName; QStringList sl;
-  for (i=1; i<n; ++i)
-    {
-      sl=ignoredDatasetsPtr->at(i).split(","); removedPrmName=sl.at(1);
-      if (cruise==sl.at(0) &&
-        (removedPrmName=="*" || prmName==removedPrmName)) return true;
-    }
+  QHash<QString,RemovedParams>::ConstIterator it=removedPrmsByCruise.constFind(cruise);
+  if (it==removedPrmsByCruise.constEnd()) return false;
+  return it.value().isAllRemoved || it.value().prmNames.contains(prmName);
+}
 
-  return false;
+/**************************************************************************/
+void DatasetInfos::setColumnIndexes()
+/**************************************************************************/
+/*!
+
+\brief Determines the indexes of the columns used by this class.
+
+*/
+{
+  idxCruise=columnIndexOf("CRUISE");
+  idxGeotracesCruise=columnIndexOf("GEOTRACES CRUISE");
+  idxPrmBarcode=columnIndexOf("PARAMETER::BARCODE");
+  idxGdacDatasetId=columnIndexOf("GDAC DATASET ID");
+  idxSiApproval=columnIndexOf("S&I STATUS");
+  idxPiPermission=columnIndexOf("PERMISSION");
+  idxDataGenerator=columnIndexOf("DATA GENERATOR(S)");
+  idxAuthorisedScientist=columnIndexOf("AUTORISED SCIENTIST");
+  idxIdpVersion=columnIndexOf("IDP Version");
 }
 
 /**************************************************************************/
@@ -280,3 +343,23 @@ void DatasetInfos::writeContributingScientistsInfo(const RTable& piInfosByName)
   appendRecords(idpErrorsDir+"Unidentified_Contributing_Scientist_Names.txt",
                 unidentifiedNames,true);
 }
+
+/**************************************************************************/
+void DatasetInfos::writeTo(QDataStream& out) const
+/**************************************************************************/
+/*!
+
+\brief Writes the DOoR dataset entries and the derived acceptance
+information to binary stream \a out.
+
+The ignored datasets list is not written. It is recompiled when
+reading.
+
+*/
+{
+  RTable::writeTo(out);
+
+  out << acceptedPrmsByContribNames << acceptedContribNamesByPrms
+      << acceptedContribNamesByUPrms << prmNamesAccepted
+      << extPrmNamesSiApproved << extPrmNamesPiApproved << sectsByCruiseName;
+}
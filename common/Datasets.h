@@ -10,7 +10,9 @@
 **
 ****************************************************************************/
 
+#include <QHash>
 #include <QMap>
+#include <QSet>
 #include <QString>
 #include <QStringList>
 
@@ -19,6 +21,23 @@
 
 class CruisesDB;
 
+/**************************************************************************/
+class RemovedParams
+/**************************************************************************/
+/*!
+
+  \brief Removed parameters of one cruise, as compiled from the
+  ignored datasets list.
+
+*/
+{
+public:
+  RemovedParams() : isAllRemoved(false) { }
+
+  bool isAllRemoved;      //!< all parameters of the cruise are removed ("*")
+  QSet<QString> prmNames; //!< names of individually removed parameters
+};
+
 /**************************************************************************/
 class DatasetInfos : public RTable
 /**************************************************************************/
@@ -31,18 +50,24 @@ class DatasetInfos : public RTable
 public:
   DatasetInfos(const QString& fn,const QString& keyLabel,QChar splitChar,
                QStringList *ignoredDatasets);
+  DatasetInfos(QDataStream& in,QStringList *ignoredDatasets);
 
+  void compileIgnoredDatasets();
   QString geotracesCruiseNameFor(const QString& cruise);
   bool hasApprovalsForExtendedParamName(const QString& extPrmName);
   bool hasApprovalsForParamName(const QString& prmName);
-  bool isRemovedDataset(const QString& cruise,const QString& prmName);
+  bool isRemovedDataset(const QString& cruise,const QString& prmName) const;
   QMap<QString,QString>* sectionsByCruisePtr() { return &sectsByCruiseName; }
+  void setColumnIndexes();
   QStringList toCruisesStringList(CruisesDB *cruises);
   void writeContributingScientistsInfo(const RTable& piInfosByName);
+  void writeTo(QDataStream& out) const;
 
   int idxCruise,idxGeotracesCruise,idxPrmBarcode,idxSiApproval,idxPiPermission;
   int idxGdacDatasetId,idxDataGenerator,idxAuthorisedScientist,idxIdpVersion;
   QStringList *ignoredDatasetsPtr;
+  QHash<QString,RemovedParams> removedPrmsByCruise;
+  //!< removed parameters (value) by cruise names (keys), compiled from ignoredDatasetsPtr
   QMap<QString,QMap<QString,int> > acceptedPrmsByContribNames;
   //!< accepted parameter names (value) by data contributor names (!removed and S&I approved and PI permitted)
   QMap<QString,QMap<QString,int> > acceptedContribNamesByPrms;
@@ -9,17 +9,23 @@
 
 #include "EventData.h"
 
+#include <algorithm>
+
 #include <QDir>
 #include <QFile>
+#include <QHash>
 #include <QMap>
-#include <QTextStream>
+#include <QReadWriteLock>
+#include <QVarLengthArray>
 #include <QVector>
 
 #include "globalVars.h"
 #include "globalFunctions.h"
 #include "Cruises.h"
+#include "InfoFileRegistry.h"
 #include "Params.h"
 #include "RRandomVar.h"
+#include "RTextTemplate.h"
 #include "UnitConverter.h"
 
 #include "common/odv.h"
@@ -40,6 +46,7 @@ EventData::EventData(Station *station,int eventIdx,
     docuByExtPrmNamePtr(docuByExtPrmName),bioGeotracesInfosPtr(bioGeotracesInfos),
     unitConvPtr(unitConverter),bottleFlagDescrPtr(bottleFlagDescr),
     piInfosByNamePtr(piInfosByName),infoDir(infoFileDir),
+    infoFileRegistryPtr(NULL),infoFileUsesPtr(NULL),hasPopulatedColumns(false),
     pressureID(-2),depthID(-1),unifiedPrms(paramSet->hasUnifiedPrms())
 /**************************************************************************/
 /*!
@@ -57,22 +64,22 @@ EventData::EventData(Station *station,int eventIdx,
   /* construct list of bottle numbers for this event */
   QList<int> dataIdxs=dataItemListPtr->dataIdxsByEvent.value(eventInfo.eventNumber);
   int i,n,bodcBottleNumber,cellCount,smplCount,dataItemCount=dataIdxs.size();
-  DataItem di; QString prmName,uPrmName,extPrmName,barcode,cellSampleId,ssSuffix;
+  QString prmName,uPrmName,extPrmName,barcode,cellSampleId;
   QStringList barcodes,extPrmNames,cellSampleIds; QList<int> dataIds;
   int nextDataId=-1;
   for (i=0; i<dataItemCount; ++i)
     {
-      di=dataItemListPtr->itemAt(dataIdxs.at(i));
-      bodcBottleNumber=di.bodcBottleNumber;
+      DataItemView di=dataItemListPtr->itemAt(dataIdxs.at(i));
+      bodcBottleNumber=di.bodcBottleNumber();
       if (!bodcBottleNumbers.contains(bodcBottleNumber))
         {
           bodcBottleNumbers.append(bodcBottleNumber);
-          bodcBottleFlags.append(di.bodcBottleFlag);
-          rosetteBottleNumbers.append(di.rosetteBottleNumber);
-          geotracesSampleIds.append(di.geotracesSampleId);
+          bodcBottleFlags.append(di.bodcBottleFlag());
+          rosetteBottleNumbers.append(di.rosetteBottleNumber());
+          geotracesSampleIds.append(di.geotracesSampleId());
         }
 
-      cellSampleId=di.cellSampleId;
+      cellSampleId=di.cellSampleId();
       cellSampleIds=cellSampleIdsByBodcBottleNumber.value(bodcBottleNumber);
       if (!cellSampleId.isEmpty() && !cellSampleIds.contains(cellSampleId))
         {
@@ -80,10 +87,10 @@ EventData::EventData(Station *station,int eventIdx,
           cellSampleIdsByBodcBottleNumber.insert(bodcBottleNumber,cellSampleIds);
         }
 
-      extPrmName=di.parameter;
-      prmName=Param::paramNameFromExtendedName(extPrmName,&barcode);
-      uPrmName=(paramSet->hasUnifiedPrms()) ?
-        Param::unifiedNameLabel(prmName,ssSuffix) : prmName;
+      extPrmName=di.parameter();
+      ExtendedNameInfo ei=Param::extendedNameInfo(extPrmName);
+      prmName=ei.name; barcode=ei.barcode;
+      uPrmName=(paramSet->hasUnifiedPrms()) ? ei.unifiedName : prmName;
 
       barcodes=barcodesByPrmName.value(prmName);
       dataIds=dataIdsByUPrmName.value(uPrmName);
@@ -97,6 +104,7 @@ EventData::EventData(Station *station,int eventIdx,
           dataIdsByUPrmName.insert(uPrmName,dataIds);
           extPrmNames.append(extPrmName);
           extPrmNamesByUPrmName.insert(uPrmName,extPrmNames);
+          extPrmNamesByDataId.append(extPrmName);
         }
     }
 
@@ -129,19 +137,19 @@ EventData::EventData(Station *station,int eventIdx,
   // int dmy;
   for (i=0; i<dataItemCount; ++i)
     {
-      di=dataItemListPtr->itemAt(dataIdxs.at(i));
-      bodcBottleNumber=di.bodcBottleNumber;
+      DataItemView di=dataItemListPtr->itemAt(dataIdxs.at(i));
+      bodcBottleNumber=di.bodcBottleNumber();
 
-      // if (bodcBottleNumber==1400600 && di.parameter.startsWith("Ra_226_D_CONC_BOTTLE"))
+      // if (bodcBottleNumber==1400600 && di.parameter().startsWith("Ra_226_D_CONC_BOTTLE"))
       //   dmy=1;
 
-      smplId=sampleId(bodcBottleNumber,di.cellSampleId);
-      dataId=dataIdFromExtendedName(di.parameter,paramSetPtr->hasUnifiedPrms());
+      smplId=sampleId(bodcBottleNumber,di.cellSampleId());
+      dataId=dataIdFromExtendedName(di.parameter(),paramSetPtr->hasUnifiedPrms());
       if (smplId==-1 || dataId==-1) continue;
 
       /* retrieve depth and pressure values. ensure both exist. */
-      pressVal=di.pressure;
-      depthVal=di.depth;
+      pressVal=di.pressure();
+      depthVal=di.depth();
       if      (pressVal==ODV::missDOUBLE && depthVal!=ODV::missDOUBLE)
         pressVal=calPressEOS80(depthVal,si.meanLat);
       else if (pressVal!=ODV::missDOUBLE && depthVal==ODV::missDOUBLE)
@@ -150,9 +158,9 @@ EventData::EventData(Station *station,int eventIdx,
       /* assign values */
       pressure[smplId]=pressVal;
       depth[smplId]=depthVal;
-      ((double*) dblData.data(dataId))[smplId]=di.parameterValue;
-      ((double*) errData.data(dataId))[smplId]=di.standardDevValue;
-      ((char*) qfData.data(dataId))[smplId]=di.flag;
+      ((double*) dblData.data(dataId))[smplId]=di.parameterValue();
+      ((double*) errData.data(dataId))[smplId]=di.standardDevValue();
+      ((char*) qfData.data(dataId))[smplId]=di.flag();
     }
 }
 
@@ -183,6 +191,43 @@ QStringList EventData::paramNamesForUPrmName(const QString& uPrmName,
   return sl;
 }
 
+/**************************************************************************/
+void EventData::buildPopulatedColumns()
+/**************************************************************************/
+/*!
+
+  \brief Determines the spreadsheet columns of the parameters with data
+  in this event and stores them, together with the storage addresses
+  of their contributors, in \a populatedColumns.
+
+*/
+{
+  populatedColumns.clear();
+  QList<int> columns; QStringList prmNames,barcodes; int i,dataId;
+  QMap<QString,QStringList>::ConstIterator it;
+  for (it=extPrmNamesByUPrmName.constBegin(); it!=extPrmNamesByUPrmName.constEnd(); ++it)
+    {
+      columns=paramSetPtr->paramColumnsOf(it.key());
+      if (columns.isEmpty()) continue;
+
+      EventDataColumn col; col.prmName=it.key();
+      prmNames=paramNamesForUPrmName(it.key(),barcodes);
+      for (i=0; i<prmNames.size(); ++i)
+        {
+          dataId=dataIdFromExtendedName(prmNames.at(i)+"::"+barcodes.at(i),unifiedPrms);
+          col.dblPtrs.append((const double*) dblData.data(dataId));
+          col.errPtrs.append((const double*) errData.data(dataId));
+          col.qfPtrs.append((const char*) qfData.data(dataId));
+        }
+      col.lastPrmName=prmNames.last();
+
+      for (i=0; i<columns.size(); ++i)
+        { col.column=columns.at(i); populatedColumns.append(col); }
+    }
+  std::sort(populatedColumns.begin(),populatedColumns.end());
+  hasPopulatedColumns=true;
+}
+
 /**************************************************************************/
 int EventData::dataIdFromExtendedName(const QString& extPrmName,
                                       bool hasUnifiedPrms)
@@ -198,10 +243,8 @@ int EventData::dataIdFromExtendedName(const QString& extPrmName,
 
 */
 {
-  QString prmName,uPrmName,barcode,ssSuffix;
-  prmName=Param::paramNameFromExtendedName(extPrmName,&barcode);
-  uPrmName=(hasUnifiedPrms) ?
-    Param::unifiedNameLabel(prmName,ssSuffix) : prmName;
+  ExtendedNameInfo ei=Param::extendedNameInfo(extPrmName);
+  const QString& uPrmName=(hasUnifiedPrms) ? ei.unifiedName : ei.name;
   int idx=extPrmNamesByUPrmName.value(uPrmName).indexOf(extPrmName);
   return (idx==-1) ? -1 : dataIdsByUPrmName.value(uPrmName).at(idx);
 }
@@ -221,68 +264,187 @@ int EventData::firstSampleId(int bodcBottleNumber)
 }
 
 /**************************************************************************/
-void EventData::getValues(const QString& uPrmName,int smplIdx,
+void EventData::getValues(EventDataColumn& col,int smplIdx,
                           double &val,double &err,char &qf,QString &infoStr)
 /**************************************************************************/
 /*!
 
-  \brief Gets the values for parameter name \a uPrmName and sample
+  \brief Gets the values for spreadsheet column \a col and sample
   index \a smplIdx.
 
-  \return \c true if successful, or \c false otherwise.
+  If more than one contributor has a value, the median value and the
+  combined quality flag are returned.
 
 */
 {
   /* initialize values */
   val=err=ODV::missDOUBLE; qf='9'; infoStr="";
 
-  QStringList extPrmNames=extPrmNamesByUPrmName.value(uPrmName);
-  QStringList barcodes,prmNames=paramNamesForUPrmName(uPrmName,barcodes);
-  int i,contribCount=barcodes.size(),valueCount,dataId; QString prmName;
+  int i,contribCount=col.dblPtrs.size(),valueCount;
   if (contribCount==0) return;
 
-  QVector<double> vals,errs; QList<char> qfs;
-  QList<int> contribIdxs; double lVal,lErr; char lQf;
-  QMap<QString,int> infoFiles;
+  QVarLengthArray<double,16> vals; QVarLengthArray<int,16> contribIdxs;
+  quint64 mask=0; double lVal;
 
   /* loop over all contributors and collect values */
   for (i=0; i<contribCount; ++i)
     {
-      prmName=prmNames.at(i);
-      dataId=dataIdFromExtendedName(prmName+"::"+barcodes.at(i),unifiedPrms);
-      lVal=((double*) dblData.data(dataId))[smplIdx];
-      lErr=((double*) errData.data(dataId))[smplIdx];
-      lQf=((char*) qfData.data(dataId))[smplIdx];
-
+      lVal=col.dblPtrs.at(i)[smplIdx];
       if (lVal!=ODV::missDOUBLE)
         {
-          contribIdxs.append(i);
-          vals.append(lVal); errs.append(lErr); qfs.append(lQf);
+          contribIdxs.append(i); vals.append(lVal);
+          if (i<64) mask|=(Q_UINT64_C(1)<<i);
         }
     }
 
   valueCount=vals.size();
   if      (valueCount==1)
-    { val=vals.at(0); err=errs.at(0); qf=qfs.at(0); }
+    {
+      i=contribIdxs.at(0); val=vals.at(0);
+      err=col.errPtrs.at(i)[smplIdx]; qf=col.qfPtrs.at(i)[smplIdx];
+    }
   else if (valueCount>1)
     {
+      QList<char> qfs;
+      for (i=0; i<valueCount; ++i) qfs.append(col.qfPtrs.at(contribIdxs.at(i))[smplIdx]);
       RRandomVar rv(valueCount,vals.data(),ODV::missDOUBLE);
       val=rv.median(); err=ODV::missDOUBLE; qf=combinedSdnQualityFlag(qfs);
     }
 
-  /* assign the info string and write info file, if necessary */
+  /* assign the info string and write info file, if necessary. the
+     info file of a contributor combination is the same for all
+     samples of the event and is written only once. */
   if (valueCount>0)
     {
-      QString infoFn=infoFileName(prmName,contribIdxs);
-      infoStr=QString("lf:infos/%1.html").arg(infoFn);
-      if (!infoFiles.contains(infoFn))
-        {
-          writeInfoFile(infoFn,prmName,contribIdxs);
-          infoFiles.insert(infoFn,1);
-        }
+      bool isCacheable=(contribCount<=64);
+      if (isCacheable && col.infoStrsByMask.contains(mask))
+        { infoStr=col.infoStrsByMask.value(mask); return; }
+
+      QList<int> idxList;
+      for (i=0; i<valueCount; ++i) idxList.append(contribIdxs.at(i));
+      QString infoFn=infoFileName(col.lastPrmName,idxList);
+      infoStr="lf:infos/"+infoFn+".html";
+      writeInfoFile(infoFn,col.lastPrmName,idxList);
+      if (isCacheable) col.infoStrsByMask.insert(mask,infoStr);
     }
 }
 
+/**************************************************************************/
+QByteArray EventData::infoFileContents(const QString& prmName,
+                                       const QList<int> idxList)
+/**************************************************************************/
+/*!
+
+  \brief Renders the INFO file for parameter \a prmName with
+  contributing data from barcode indexes in \a idxList.
+
+  The page is assembled from a precompiled template and cached
+  contributor fragments (see infoFileFragment()).
+
+  \return The UTF-8 encoded file contents.
+
+*/
+{
+  static const RTextTemplate pageTmpl(
+    "<!DOCTYPE html>\n<html>\n\n<head>\n<title>%1 Info</title>\n<meta charset=\"UTF-8\">\n<style type=\"text/css\">\nbody { font-family: sans-serif; margin: 30px; }\nh2, h3 { color:#4070AA; }\np { line-height: 1.5; };\n</style>\n</head>\n\n<body>\n\n"
+    "<p>\n<h2>%2</h2>\n</p><br>\n\n"
+    "<p>\n<h3>&#149; Parameter Description</h3>\n%3\n</p><br>\n\n"
+    "<p>\n<h3>&#149; Data Originators and Methods</h3>\n%4</p><br>\n"
+    "<p>\n<h3>&#149; Processing Information</h3>\n%5\n</p><br>\n\n"
+    "<p>\n<h3>&#149; References</h3>\n%6</p><br>\n\n"
+    "</body>\n</html>\n");
+  static const RTextTemplate pubUrlTmpl(fmtPublicationUrl);
+  const QString fmtA="<a href=\"%1\">%2</a>\n";
+  const QString pubLinkLbl="Link to publications asociated with these data";
+  const QString proc1="As provided.";
+  const QString proc2="Value obtained as median of data values from above originators. Quality flag is combination of individual flags (poorest quality).";
+  const QString proc3="Values from sampling device UCCTD flagged bad. Reason uncalibrated and systematically too low.";
+  QString cruise=stationPtr->cruiseLbl;
+  QString cruiseInfoUrl=cruisesPtr->value(cruise).at(cruisesPtr->idxCruiseReportUrl);
+  QString geotracesCruise=datasetInfosPtr->sectionsByCruisePtr()->value(cruise);
+  int i,n=idxList.size();
+  QString uPrmName,sSuffix,heading,pubLink; QStringList extPrmNames;
+  uPrmName=(unifiedPrms) ? Param::unifiedNameLabel(prmName,sSuffix) : prmName;
+  extPrmNames=extPrmNamesByUPrmName.value(uPrmName);
+
+  QString procInfo=(n>1) ? proc2 : proc1;
+  if (geotracesCruise=="GA10" && uPrmName=="CTDOXY_UP_D_CONC_SENSOR")
+    procInfo=proc3;
+
+  /* chained QString::arg() calls re-interpret place markers in the
+     substituted values. names containing '%' are therefore formatted
+     with QString::arg(), all others by plain concatenation. */
+  if (uPrmName.contains('%') || geotracesCruise.contains('%') || cruise.contains('%'))
+    {
+      heading=QString("%1 @ %2 (%3)").arg(uPrmName).arg(geotracesCruise).arg(cruise);
+      pubLink=fmtA.arg(fmtPublicationUrl.arg(geotracesCruise).arg(uPrmName))
+        .arg(pubLinkLbl);
+    }
+  else
+    {
+      heading=uPrmName+" @ "+geotracesCruise+" ("+cruise+")";
+      pubLink="<a href=\""+QString::fromUtf8(pubUrlTmpl.render(QList<QByteArray>()
+        << geotracesCruise.toUtf8() << uPrmName.toUtf8()))+"\">"+pubLinkLbl+"</a>\n";
+    }
+
+  /* assemble the contributor fragments */
+  QByteArray contribs;
+  for (i=0; i<n; ++i)
+    contribs+=infoFileFragment(extPrmNames.at(idxList.at(i)),cruiseInfoUrl);
+
+  return pageTmpl.render(QList<QByteArray>()
+                         << prmName.toUtf8() << heading.toUtf8()
+                         << paramSetPtr->paramFor(uPrmName).description.toUtf8()
+                         << contribs << procInfo.toUtf8() << pubLink.toUtf8());
+}
+
+/**************************************************************************/
+QByteArray EventData::infoFileFragment(const QString& extPrmName,
+                                       const QString& cruiseInfoUrl)
+/**************************************************************************/
+/*!
+
+  \brief Renders the INFO file fragment for contributing extended
+  parameter name \a extPrmName with cruise information URL \a
+  cruiseInfoUrl.
+
+  Fragments are cached, so that the documentation, dataset and PI
+  information of every contributor is looked up only once per
+  run. This function is thread-safe.
+
+  \return The UTF-8 encoded fragment.
+
+*/
+{
+  static QHash<QString,QByteArray> fragmentsByKey;
+  static QReadWriteLock lock;
+  const QString key=extPrmName+QChar('\n')+cruiseInfoUrl;
+
+  {
+    QReadLocker locker(&lock);
+    QHash<QString,QByteArray>::ConstIterator it=fragmentsByKey.constFind(key);
+    if (it!=fragmentsByKey.constEnd()) return it.value();
+  }
+
+  const QString fmtA="<a href=\"%1\">%2</a>\n";
+  RTableRow mi=docuByExtPrmNamePtr->value(extPrmName);
+  RTableRow di=datasetInfosPtr->value(extPrmName);
+  QString methodsUrl=mi.at(1);
+  QStringList piNames=di.at(datasetInfosPtr->idxDataGenerator).split(" | ");
+
+  QString s=QString("<p>%1<br><br>\n")
+    .arg(sortedNameList(piNames,false,piInfosByNamePtr).join(" | "));
+  s+=fmtA.arg(methodsUrl).arg("Link to detailed originator and methods information");
+  s+=" | \n";
+  s+=fmtA.arg(cruiseInfoUrl).arg("Link to cruise information");
+  s+="</p>\n";
+  QByteArray ba=s.toUtf8();
+
+  QWriteLocker locker(&lock);
+  fragmentsByKey.insert(key,ba);
+  return ba;
+}
+
 /**************************************************************************/
 QString EventData::infoFileName(const QString& prmName,const QList<int> idxList)
 /**************************************************************************/
@@ -447,23 +609,31 @@ QString EventData::spreadsheetDataPart(int bodcBottleNumber,int cellSampleIdx)
 
 */
 {
-  const QString fmt="\t%1\t%2\t%3\t%4";
   int smplIdx=firstSampleId(bodcBottleNumber);
   if (smplIdx==-1) return QString();
   smplIdx+=cellSampleIdx;
 
   QString s,infoStr; double val,err; char qf;
+  if (!hasPopulatedColumns) buildPopulatedColumns();
 
-  /* iterate over all parameters */
-  QMap<int,Param> *paramMap=paramSetPtr->paramMapPtr();
-  QMap<int,Param>::ConstIterator it;
-  for (it=paramMap->constBegin(); it!=paramMap->constEnd(); ++it)
+  /* iterate over the parameters with data. parameters without data
+     have no contributors and are emitted as constant empty fields. */
+  int i,column=0,n=populatedColumns.size();
+  for (i=0; i<n; ++i)
     {
-      getValues(it.value().name,smplIdx,val,err,qf,infoStr);
-
-      s+=fmt.arg(formattedNumber(val,6))
-        .arg(formattedNumber(err,6)).arg(qf).arg(infoStr);
+      EventDataColumn& col=populatedColumns[i];
+      paramSetPtr->appendEmptyParamFields(s,col.column-column);
+      column=col.column+1;
+      getValues(col,smplIdx,val,err,qf,infoStr);
+
+      /* same as "\t%1\t%2\t%3\t%4" with formattedNumber(val,6),
+         formattedNumber(err,6), qf and infoStr */
+      s+=QChar('\t'); appendFormattedNumber(s,val,6);
+      s+=QChar('\t'); appendFormattedNumber(s,err,6);
+      s+=QChar('\t'); s+=QLatin1Char(qf);
+      s+=QChar('\t'); s+=infoStr;
     }
+  paramSetPtr->appendEmptyParamFields(s,paramSetPtr->paramColumnCount()-column);
 
   return s;
 }
@@ -592,74 +762,73 @@ QStringList EventData::spreadsheetHeaderLines(ParamSet *paramSet,
 }
 
 /**************************************************************************/
-void EventData::writeInfoFile(const QString& fn,const QString& prmName,
-                              const QList<int> idxList)
+void EventData::switchToUnifiedParams(ParamSet *uParamSet,
+                                      const QString& uInfoFileDir)
 /**************************************************************************/
 /*!
 
-  \brief Writes the INFO file for parameter \a prmName with contributing data
-  from barcode indexes in \a idxList.
+  \brief Switches this object from the non-unified parameter set to the
+  unified parameter set \a uParamSet and info file directory \a
+  uInfoFileDir.
+
+  The data values are the same for both parameter sets, only the
+  grouping of data ids by parameter name changes. Data ids are assigned
+  in order of first appearance, so that regrouping in data id order
+  yields the same contributor order as collating the event with \a
+  uParamSet from scratch.
 
 */
 {
-  const QString fmtA="<a href=\"%1\">%2</a>\n";
-  const QString proc1="As provided.";
-  const QString proc2="Value obtained as median of data values from above originators. Quality flag is combination of individual flags (poorest quality).";
-  const QString proc3="Values from sampling device UCCTD flagged bad. Reason uncalibrated and systematically too low.";
-  QString cruise=stationPtr->cruiseLbl;
-  QString cruiseInfoUrl=cruisesPtr->value(cruise).at(cruisesPtr->idxCruiseReportUrl);
-  QString geotracesCruise=datasetInfosPtr->sectionsByCruisePtr()->value(cruise);
-  int i,n=idxList.size(); RTableRow mi,di;
-  QString extPrmName,uPrmName,sSuffix,methodsUrl,methodsId,piEmail;
-  QStringList piNames,extPrmNames,sl;
-  uPrmName=(unifiedPrms) ? Param::unifiedNameLabel(prmName,sSuffix) : prmName;
-  extPrmNames=extPrmNamesByUPrmName.value(uPrmName);
+  if (unifiedPrms) return;
 
-  QString procInfo=(n>1) ? proc2 : proc1;
-  if (geotracesCruise=="GA10" && uPrmName=="CTDOXY_UP_D_CONC_SENSOR")
-    procInfo=proc3;
-
-  QFile f(infoDir+fn+".html");
-  if (f.open(QIODevice::WriteOnly))
+  dataIdsByUPrmName.clear(); extPrmNamesByUPrmName.clear();
+  int dataId,n=extPrmNamesByDataId.size(); QString extPrmName,uPrmName;
+  for (dataId=0; dataId<n; ++dataId)
     {
-      QTextStream out(&f); out.setCodec("UTF-8");
-
-      out << QString("<!DOCTYPE html>\n<html>\n\n<head>\n<title>%1 Info</title>\n<meta charset=\"UTF-8\">\n<style type=\"text/css\">\nbody { font-family: sans-serif; margin: 30px; }\nh2, h3 { color:#4070AA; }\np { line-height: 1.5; };\n</style>\n</head>\n\n<body>\n\n").arg(prmName);
-
-      out << QString("<p>\n<h2>%1 @ %2 (%3)</h2>\n</p><br>\n\n")
-              .arg(uPrmName).arg(geotracesCruise).arg(cruise);
+      extPrmName=extPrmNamesByDataId.at(dataId);
+      uPrmName=Param::extendedNameInfo(extPrmName).unifiedName;
+      dataIdsByUPrmName[uPrmName].append(dataId);
+      extPrmNamesByUPrmName[uPrmName].append(extPrmName);
+    }
 
-      out << QString("<p>\n<h3>&#149; Parameter Description</h3>\n");
-      out << paramSetPtr->paramFor(uPrmName).description << "\n</p><br>\n\n";
+  paramSetPtr=uParamSet; unifiedPrms=true; infoDir=uInfoFileDir;
+  hasPopulatedColumns=false;
+}
 
-      out << QString("<p>\n<h3>&#149; Data Originators and Methods</h3>\n");
-      for (i=0; i<n; ++i)
-        {
-          extPrmName=extPrmNames.at(idxList.at(i));
-          mi=docuByExtPrmNamePtr->value(extPrmName);
-          di=datasetInfosPtr->value(extPrmName);
-          methodsUrl=mi.at(1); methodsId=methodsIdFromUrl(methodsUrl);
-          piNames=di.at(datasetInfosPtr->idxDataGenerator).split(" | ");
-
-          out << QString("<p>%1<br><br>\n")
-            .arg(sortedNameList(piNames,false,piInfosByNamePtr).join(" | "));
-          //out << QString();
-          out << fmtA.arg(methodsUrl)
-            .arg("Link to detailed originator and methods information");
-          out << " | \n";
-          out << fmtA.arg(cruiseInfoUrl).arg("Link to cruise information");
-          out << "</p>\n";
-        }
-      out << "</p><br>\n";
+/**************************************************************************/
+void EventData::writeInfoFile(const QString& fn,const QString& prmName,
+                              const QList<int> idxList)
+/**************************************************************************/
+/*!
 
-      out << QString("<p>\n<h3>&#149; Processing Information</h3>\n");
-      out << procInfo << "\n</p><br>\n\n";
+  \brief Writes the INFO file \a fn for parameter \a prmName with
+  contributing data from barcode indexes in \a idxList.
 
-      out << QString("<p>\n<h3>&#149; References</h3>\n");
-      out << fmtA.arg(fmtPublicationUrl.arg(geotracesCruise).arg(uPrmName))
-              .arg("Link to publications asociated with these data");
-      out << "</p><br>\n\n";
+  If \a infoFileRegistryPtr is not \c NULL, the file is only rendered
+  if the registry does not yet have its contents, and the use of the
+  file is recorded in the registry (or appended to \a infoFileUsesPtr,
+  if not \c NULL). The registry writes the file later.
 
-      out << "</body>\n</html>\n";
+*/
+{
+  const QString path=infoDir+fn+".html";
+  if (!infoFileRegistryPtr)
+    {
+      QFile f(path);
+      if (f.open(QIODevice::WriteOnly)) f.write(infoFileContents(prmName,idxList));
+      return;
     }
+
+  /* the contents are determined by the contributing extended names */
+  QString sSuffix,uPrmName=(unifiedPrms) ?
+    Param::unifiedNameLabel(prmName,sSuffix) : prmName;
+  QStringList extPrmNames=extPrmNamesByUPrmName.value(uPrmName),sl;
+  int i,n=idxList.size();
+  for (i=0; i<n; ++i) sl << extPrmNames.at(idxList.at(i));
+  const QString key=sl.join(";");
+
+  if (infoFileRegistryPtr->claim(path,key))
+    infoFileRegistryPtr->setContents(path,key,infoFileContents(prmName,idxList));
+  if (infoFileUsesPtr) infoFileUsesPtr->append(qMakePair(path,key));
+  else                 infoFileRegistryPtr->use(path,key);
 }
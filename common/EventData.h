@@ -10,9 +10,14 @@
 **
 ****************************************************************************/
 
+#include <QByteArray>
+#include <QHash>
+#include <QList>
 #include <QMap>
+#include <QPair>
 #include <QString>
 #include <QStringList>
+#include <QVector>
 
 #include "globalDefines.h"
 #include "Events.h"
@@ -22,11 +27,38 @@
 class CruisesDB;
 class DataItemList;
 class DatasetInfos;
+class InfoFileRegistry;
 class ParamSet;
 class Station;
 class UnitConverter;
 
 
+/**************************************************************************/
+class EventDataColumn
+/**************************************************************************/
+/*!
+
+  \brief Spreadsheet column of a parameter with data in one event.
+
+  Holds the storage addresses of the values, errors and quality flags
+  of all contributors, so that no name lookups are needed per sample.
+
+*/
+{
+public:
+  bool operator<(const EventDataColumn& other) const
+  { return column<other.column; }
+
+  int column;            //!< spreadsheet column index (see ParamSet::paramColumnsOf())
+  QString prmName;       //!< (unified) parameter name of the column
+  QString lastPrmName;   //!< parameter name of the last contributor (names the info files)
+  QVector<const double*> dblPtrs; //!< value storage of the contributors
+  QVector<const double*> errPtrs; //!< 1-sigma value storage of the contributors
+  QVector<const char*> qfPtrs;    //!< quality flag storage of the contributors
+  QHash<quint64,QString> infoStrsByMask;
+  //!< info strings by bit mask of contributors with values
+};
+
 /**************************************************************************/
 class EventData
 /**************************************************************************/
@@ -45,10 +77,13 @@ public:
             QMap<char,QString> *bottleFlagDescr,
             const QString& infoFileDir);
 
+  void buildPopulatedColumns();
   int dataIdFromExtendedName(const QString& extPrmName,bool hasUnifiedPrms);
   int firstSampleId(int bodcBottleNumber);
-  void getValues(const QString& uPrmName,int smplIdx,
+  void getValues(EventDataColumn& col,int smplIdx,
                  double &val,double &err,char &qf,QString &infoStr);
+  QByteArray infoFileContents(const QString& prmName,const QList<int> idxList);
+  QByteArray infoFileFragment(const QString& extPrmName,const QString& cruiseInfoUrl);
   QString infoFileName(const QString& prmName,const QList<int> idxList);
   QString metaValueString(bool inclMetaValues);
   QString methodsIdFromUrl(const QString& methodsUrl);
@@ -61,6 +96,7 @@ public:
   QStringList spreadsheetDataLines();
   static QStringList spreadsheetHeaderLines(ParamSet *paramSet,
                                             RTable *keyVarsByDataVar);
+  void switchToUnifiedParams(ParamSet *uParamSet,const QString& uInfoFileDir);
   void writeInfoFile(const QString& fn,const QString& prmName,
                      const QList<int> idxList);
 
@@ -77,6 +113,10 @@ public:
   QMap<char,QString> *bottleFlagDescrPtr; //!<
   //!< pointer to bottle flag description dictionary
   QString infoDir; //!< directory for info files
+  InfoFileRegistry *infoFileRegistryPtr;
+  //!< if not NULL, info files are generated once and written by this registry
+  QList<QPair<QString,QString> > *infoFileUsesPtr;
+  //!< if not NULL, info file paths and content keys are appended here instead of being used in the registry
   bool unifiedPrms; //!< Flag indicating whether parameters are unified or not
 
   /* storage for numeric and string data variables */
@@ -90,6 +130,11 @@ public:
   //!< data ids by (unified) parameter name for this event
   QMap<QString,QStringList> extPrmNamesByUPrmName;
   //!< extended parameter names by (unified) parameter name for this event
+  QStringList extPrmNamesByDataId;
+  //!< extended parameter names by data id (index) for this event
+  QVector<EventDataColumn> populatedColumns;
+  //!< spreadsheet columns of parameters with data in this event, by column index
+  bool hasPopulatedColumns; //!< populatedColumns is up to date
   QList<char> bodcBottleFlags; //!< list of BODC bottle flags for this event
   QList<int> rosetteBottleNumbers; //!< list of BODC bottle numbers for this event
   QStringList geotracesSampleIds; //!< list of GEOTRACES sample ids for this event
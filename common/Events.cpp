@@ -10,7 +10,13 @@
 
 #include <math.h>
 
+#include <algorithm>
+
 #include <QDir>
+#include <QHash>
+#include <QPair>
+#include <QtNumeric>
+#include <QVector>
 // #include <QFile>
 // #include <QMap>
 // #include <QTextStream>
@@ -27,6 +33,158 @@
 #include "common/RDateTime.h"
 
 
+/**************************************************************************/
+class ProximityGrid
+/**************************************************************************/
+/*!
+
+  \brief Bucket index of items by time (Gregorian days) and latitude
+  for the proximity collation of stations.
+
+  Cells are timeTolerance days wide in time and the latitude span of
+  distanceTolerance km in latitude. Since distance() is never smaller
+  than the latitude difference times 111.194929 km, all items within
+  tolerance of a position are in the cells around that position. The
+  longitude is not indexed, because distance() does not wrap at the
+  date line. candidates() returns a superset; the caller has to apply
+  the exact tolerance test.
+
+*/
+{
+public:
+  ProximityGrid(double distanceTolerance,double timeTolerance);
+
+  bool candidates(double gregDay,double lat,QList<int>& idxs) const;
+  void insert(int idx,double gregDay,double lat);
+  void remove(int idx,double gregDay,double lat);
+
+private:
+  typedef QPair<qint64,qint64> Cell;
+
+  bool cellOf(double gregDay,double lat,Cell& cell) const;
+  static bool cellRange(double v,double tol,double width,qint64& lo,qint64& hi);
+
+  QHash<Cell,QList<int> > idxsByCell; //!< item indices by cell
+  QList<int> unbinnedIdxs; //!< item indices without cell (non-finite values)
+  double dayWidth;         //!< cell width in days
+  double latWidth;         //!< cell width in degrees latitude
+  bool isBinned;           //!< false if the tolerances do not allow binning
+};
+
+/**************************************************************************/
+ProximityGrid::ProximityGrid(double distanceTolerance,double timeTolerance)
+/**************************************************************************/
+/*!
+
+  \brief Creates an empty ProximityGrid object for tolerances \a
+  distanceTolerance (in km) and \a timeTolerance (in days).
+
+*/
+{
+  dayWidth=timeTolerance; latWidth=distanceTolerance/111.194929;
+  isBinned=(qIsFinite(dayWidth) && dayWidth>0. &&
+            qIsFinite(latWidth) && latWidth>0.);
+}
+
+/**************************************************************************/
+bool ProximityGrid::candidates(double gregDay,double lat,QList<int>& idxs) const
+/**************************************************************************/
+/*!
+
+  \brief Collects the indices of all items that may be within
+  tolerance of time \a gregDay and latitude \a lat in \a idxs, sorted
+  in ascending order.
+
+  \return \c true on success, or \c false if the candidates cannot be
+  restricted and all items have to be tested.
+
+*/
+{
+  idxs.clear();
+  qint64 tLo,tHi,yLo,yHi,t,y;
+  if (!isBinned || !cellRange(gregDay,dayWidth,dayWidth,tLo,tHi) ||
+      !cellRange(lat,latWidth,latWidth,yLo,yHi)) return false;
+
+  QHash<Cell,QList<int> >::ConstIterator it;
+  for (t=tLo; t<=tHi; ++t)
+    for (y=yLo; y<=yHi; ++y)
+      if ((it=idxsByCell.constFind(Cell(t,y)))!=idxsByCell.constEnd())
+        idxs.append(it.value());
+  idxs.append(unbinnedIdxs);
+
+  std::sort(idxs.begin(),idxs.end());
+  return true;
+}
+
+/**************************************************************************/
+bool ProximityGrid::cellOf(double gregDay,double lat,Cell& cell) const
+/**************************************************************************/
+/*!
+
+  \brief Determines the cell \a cell of time \a gregDay and latitude
+  \a lat.
+
+  \return \c true on success, or \c false if there is no such cell.
+
+*/
+{
+  qint64 t,y;
+  if (!isBinned || !cellRange(gregDay,0.,dayWidth,t,t) ||
+      !cellRange(lat,0.,latWidth,y,y)) return false;
+  cell=Cell(t,y); return true;
+}
+
+/**************************************************************************/
+bool ProximityGrid::cellRange(double v,double tol,double width,
+                              qint64& lo,qint64& hi)
+/**************************************************************************/
+/*!
+
+  \brief Determines the range \a lo to \a hi of cell indices of width
+  \a width covering values \a v +/- \a tol. The tolerance is widened
+  slightly to absorb rounding differences.
+
+  \return \c true on success, or \c false if \a v is not finite or too
+  large for cell indices.
+
+*/
+{
+  const double d=tol*(1.+1.e-6),l=floor((v-d)/width),h=floor((v+d)/width);
+  if (!qIsFinite(l) || !qIsFinite(h) || fabs(l)>1.e15 || fabs(h)>1.e15)
+    return false;
+  lo=(qint64) l; hi=(qint64) h; return true;
+}
+
+/**************************************************************************/
+void ProximityGrid::insert(int idx,double gregDay,double lat)
+/**************************************************************************/
+/*!
+
+  \brief Inserts item \a idx at time \a gregDay and latitude \a lat.
+
+*/
+{
+  Cell cell;
+  if (cellOf(gregDay,lat,cell)) idxsByCell[cell].append(idx);
+  else                          unbinnedIdxs.append(idx);
+}
+
+/**************************************************************************/
+void ProximityGrid::remove(int idx,double gregDay,double lat)
+/**************************************************************************/
+/*!
+
+  \brief Removes item \a idx previously inserted at time \a gregDay
+  and latitude \a lat.
+
+*/
+{
+  Cell cell;
+  if (cellOf(gregDay,lat,cell)) idxsByCell[cell].removeOne(idx);
+  else                          unbinnedIdxs.removeOne(idx);
+}
+
+
 /**************************************************************************/
 QString EventInfo::toString(const QString& sep) const
 /**************************************************************************/
@@ -69,21 +227,21 @@ EventsDB::EventsDB(const QString& fn,const QString& keyLabel,QChar splitChar)
 
 */
 {
-  /* determine various column indexes */
-  idxCruise=columnIndexOf("CRUISE");
-  idxStation=columnIndexOf("STATION");
-  idxEventNumber=columnIndexOf("BODC_EVENT_NUMBER");
-  idxCastIdentifier=columnIndexOf("CAST_IDENTIFIER");
-  idxSamplingDevice=columnIndexOf("SAMPLING_DEVICE");
-  idxStartTimeDate=columnIndexOf("EVENT_START_TIME_DATE");
-  idxEndTimeDate=columnIndexOf("EVENT_END_TIME_DATE");
-  idxStartLongitude=columnIndexOf("EVENT_START_LONGITUDE");
-  idxEndLongitude=columnIndexOf("EVENT_END_LONGITUDE");
-  idxStartLatitude=columnIndexOf("EVENT_START_LATITUDE");
-  idxEndLatitude=columnIndexOf("EVENT_END_LATITUDE");
-  idxLongitude=columnIndexOf("LONGITUDE");
-  idxLatitude=columnIndexOf("LATITUDE");
-  idxBottomDepth=columnIndexOf("BOTTOM DEPTH [M]");
+  setColumnIndexes(); decodeEventInfos();
+}
+
+/**************************************************************************/
+EventsDB::EventsDB(QDataStream& in)
+  : RTable(in)
+/**************************************************************************/
+/*!
+
+  \brief Creates a EventsDB object and reads the events from binary
+  stream \a in (see RTable::writeTo()).
+
+*/
+{
+  setColumnIndexes(); decodeEventInfos();
 }
 
 /**************************************************************************/
@@ -147,10 +305,12 @@ void EventsDB::autoCorrectStationLabels()
           insert(key,ii);
         }
     }
+
+  decodeEventInfos();
 }
 
 /**************************************************************************/
-StationList EventsDB::collateStations(const QStringList& eventNumbers,
+StationList EventsDB::collateStations(const QVector<int>& eventNumbers,
                                       double distanceTolerance,
                                       double timeTolerance,
                                       EventsDB *eventsDB)
@@ -169,7 +329,7 @@ StationList EventsDB::collateStations(const QStringList& eventNumbers,
 
 */
 {
-  QStringList noStNameEvents;
+  QVector<int> noStNameEvents;
 
   StationList stations=
     collateStationsByStationLabel(eventNumbers,noStNameEvents,eventsDB);
@@ -184,7 +344,7 @@ StationList EventsDB::collateStations(const QStringList& eventNumbers,
 }
 
 /**************************************************************************/
-StationList EventsDB::collateStationsByProximity(const QStringList& eventNumbers,
+StationList EventsDB::collateStationsByProximity(const QVector<int>& eventNumbers,
                                                  double distanceTolerance,
                                                  double timeTolerance,
                                                  StationList& stLstByStLbl,
@@ -205,27 +365,63 @@ StationList EventsDB::collateStationsByProximity(const QStringList& eventNumbers
 {
   if (eventNumbers.isEmpty()) return StationList();
 
-  QStringList evtNumbers=eventNumbers;
-  StationList stations; Station st,stRef;
-  int i,j,m,n; double dTime,dDist,rTime,rLon,rLat;
-  RTableRow ii; EventInfo ei;
-  QString evtNumber,stationLbl,stationKey;
+  StationList stations; Station st,stRef; EventInfo ei;
+  int i,j,k,m,n=eventNumbers.size(),first,upper; bool isAdded;
+  double dTime,dDist,rTime,rLon,rLat; QList<int> idxs;
+  QVector<int> blkIdxs; QVector<double> blkLons,blkLats,blkDists;
 
-  do
+  /* times and positions of all events, binned by time and latitude */
+  QVector<double> gds(n),lons(n),lats(n); QVector<bool> isFree(n,true);
+  ProximityGrid grid(distanceTolerance,timeTolerance);
+  for (i=0; i<n; ++i)
     {
-      st=Station(this,evtNumbers.takeFirst()); n=evtNumbers.size()-1;
-      for (i=n; i>=0; --i)
+      ei=eventInfoOf(eventNumbers.at(i));
+      gds[i]=meanOf(ei.startGregorianDay,ei.endGregorianDay);
+      lons[i]=ei.longitude; lats[i]=ei.latitude;
+      grid.insert(i,gds.at(i),lats.at(i));
+    }
+
+  /* start a new station with the first free event and add the free
+    events within tolerance, scanning from the last event backwards. the
+    station mean only changes if an event is added, so the candidates
+    are queried once per station state. the running means of the
+    station are identical to the StationInfo means. */
+  for (first=0; first<n; ++first)
+    {
+      if (!isFree.at(first)) continue;
+      isFree[first]=false; st=Station(this,eventNumbers.at(first)); upper=n;
+      do
         {
-          StationInfo si(st);
-          evtNumber=evtNumbers.at(i); ei=eventInfoOf(evtNumber);
-          dTime=si.timeFrom(meanOf(ei.startGregorianDay,ei.endGregorianDay));
-          dDist=si.distanceFrom(ei.longitude,ei.latitude);
-          if (fabs(dTime)<timeTolerance && dDist<distanceTolerance)
-            { if (st.addEvent(eventsDB,evtNumber)) evtNumbers.takeAt(i); }
+          rTime=st.means.meanTime(); rLon=st.means.meanLon();
+          rLat=st.means.meanLat(); isAdded=false;
+          if (!grid.candidates(rTime,rLat,idxs))
+            for (idxs.clear(), i=0; i<upper; ++i) idxs.append(i);
+
+          /* collect the free candidates within time tolerance in scan
+            order and calculate their distances in one block */
+          blkIdxs.clear(); blkLons.clear(); blkLats.clear();
+          for (k=idxs.size()-1; k>=0; --k)
+            {
+              i=idxs.at(k); if (i>=upper || !isFree.at(i)) continue;
+              dTime=rTime-gds.at(i);
+              if (fabs(dTime)<timeTolerance)
+                { blkIdxs.append(i); blkLons.append(lons.at(i)); blkLats.append(lats.at(i)); }
+            }
+          blkDists.resize(blkIdxs.size());
+          distancesFrom(rLon,rLat,blkIdxs.size(),blkLons.constData(),
+                        blkLats.constData(),blkDists.data());
+
+          for (k=0; k<blkIdxs.size() && !isAdded; ++k)
+            {
+              i=blkIdxs.at(k);
+              if (blkDists.at(k)<distanceTolerance &&
+                  st.addEvent(eventsDB,eventNumbers.at(i)))
+                { isFree[i]=false; upper=i; isAdded=true; }
+            }
         }
+      while (isAdded);
       stations.append(st);
     }
-  while (!evtNumbers.isEmpty());
 
   /* loop over all stations and see whether any one matches one of the
   staions in stLstByStLbl (collated by station label) within given
@@ -233,19 +429,38 @@ StationList EventsDB::collateStationsByProximity(const QStringList& eventNumbers
   without station label is appended to the station with station label*/
   if ((m=stLstByStLbl.size())>0)
     {
+      QVector<double> refTimes(m),refLons(m),refLats(m);
+      ProximityGrid refGrid(distanceTolerance,timeTolerance);
+      for (j=0; j<m; ++j)
+        {
+          const StationMeans& sm=stLstByStLbl.at(j).means;
+          refTimes[j]=sm.meanTime(); refLons[j]=sm.meanLon(); refLats[j]=sm.meanLat();
+          refGrid.insert(j,refTimes.at(j),refLats.at(j));
+        }
+
       n=stations.size()-1;
       for (i=n; i>=0; --i)
         {
-          st=stations.at(i); StationInfo si(st);
-          rTime=si.meanTime; rLon=si.meanLon; rLat=si.meanLat;
-          for (j=0; j<m; ++j)
+          st=stations.at(i); rTime=st.means.meanTime();
+          rLon=st.means.meanLon(); rLat=st.means.meanLat();
+          if (!refGrid.candidates(rTime,rLat,idxs))
+            for (idxs.clear(), j=0; j<m; ++j) idxs.append(j);
+          for (k=0; k<idxs.size(); ++k)
             {
-              stRef=stLstByStLbl.at(j); si=StationInfo(stRef);
-              dTime=si.timeFrom(rTime); dDist=si.distanceFrom(rLon,rLat);
+              j=idxs.at(k);
+              dTime=refTimes.at(j)-rTime;
+              dDist=distance(refLons.at(j),refLats.at(j),rLon,rLat);
               if (fabs(dTime)<timeTolerance && dDist<distanceTolerance)
                 {
-                  stRef.addStation(st); stLstByStLbl[j]=stRef;
-                  stations.takeAt(i); break;
+                  stRef=stLstByStLbl.at(j); stRef.addStation(st);
+                  stLstByStLbl[j]=stRef; stations.takeAt(i);
+
+                  /* re-bin the modified station with its new mean */
+                  refGrid.remove(j,refTimes.at(j),refLats.at(j));
+                  refTimes[j]=stRef.means.meanTime();
+                  refLons[j]=stRef.means.meanLon(); refLats[j]=stRef.means.meanLat();
+                  refGrid.insert(j,refTimes.at(j),refLats.at(j));
+                  break;
                 }
             }
         }
@@ -256,8 +471,8 @@ StationList EventsDB::collateStationsByProximity(const QStringList& eventNumbers
 
 /**************************************************************************/
 StationList EventsDB::
-collateStationsByStationLabel(const QStringList& eventNumbers,
-                              QStringList& noNameEventNumbers,
+collateStationsByStationLabel(const QVector<int>& eventNumbers,
+                              QVector<int>& noNameEventNumbers,
                               EventsDB *eventsDB)
 /**************************************************************************/
 /*!
@@ -274,15 +489,15 @@ collateStationsByStationLabel(const QStringList& eventNumbers,
 
 */
 {
-  QMap<QString,Station> stations; RTableRow ii;
-  int i,n=eventNumbers.size();
-  QString evtNumber,stationLbl,stationKey;
+  QMap<QString,Station> stations; EventInfo ei;
+  int i,n=eventNumbers.size(),evtNumber;
+  QString stationLbl,stationKey;
 
   for (i=0; i<n; ++i)
     {
-      evtNumber=eventNumbers.at(i); ii=value(evtNumber);
-      stationLbl=ii.at(idxStation);
-      stationKey=Station::stationKey(ii.at(idxCruise),stationLbl);
+      evtNumber=eventNumbers.at(i); ei=eventInfoOf(evtNumber);
+      stationLbl=ei.stationLbl;
+      stationKey=Station::stationKey(ei.cruiseLbl,stationLbl);
 
       if (stationLbl.isEmpty())
         {
@@ -305,6 +520,38 @@ collateStationsByStationLabel(const QStringList& eventNumbers,
   return sl;
 }
 
+/**************************************************************************/
+void EventsDB::decodeEventInfos()
+/**************************************************************************/
+/*!
+
+  \brief Decodes the EventInfo objects of all events once, so that
+  eventInfoOf() does not have to parse the rows on every call.
+
+  Must be called again after rows have been changed with RTable
+  functions, such as insertFile(). The decoded infos are read-only
+  otherwise, so eventInfoOf() may be called concurrently from
+  different threads.
+
+*/
+{
+  const QStringList keys=uniqueKeys(); int i,n=keys.size(),evtNum; bool ok;
+  eventInfos.resize(n); eventRows.resize(n);
+  eventInfoIdxs.clear(); eventInfoIdxs.reserve(n);
+  eventInfoIdxsByNumber.clear(); eventInfoIdxsByNumber.reserve(n);
+  for (i=0; i<n; ++i)
+    {
+      const QString& key=keys.at(i);
+      eventRows[i]=value(key); eventInfos[i]=eventInfoOf(eventRows.at(i));
+      eventInfoIdxs.insert(key,i);
+
+      /* integer access only for keys written the way QString::number()
+        writes them, so that both ways of access find the same events */
+      evtNum=key.toInt(&ok);
+      if (ok && QString::number(evtNum)==key) eventInfoIdxsByNumber.insert(evtNum,i);
+    }
+}
+
 /**************************************************************************/
 void EventsDB::diagnoseEventCorrections()
 /**************************************************************************/
@@ -429,7 +676,24 @@ EventInfo EventsDB::eventInfoOf(const QString& eventNumberStr)
 
 */
 {
-  return eventInfoOf(value(eventNumberStr));
+  QHash<QString,int>::ConstIterator it=eventInfoIdxs.constFind(eventNumberStr);
+  return (it!=eventInfoIdxs.constEnd()) ?
+    eventInfos.at(it.value()) : eventInfoOf(value(eventNumberStr));
+}
+
+/**************************************************************************/
+EventInfo EventsDB::eventInfoOf(int eventNumber)
+/**************************************************************************/
+/*!
+
+  \brief \return The EventInfo object for BODC event number \a
+  eventNumber.
+
+*/
+{
+  QHash<int,int>::ConstIterator it=eventInfoIdxsByNumber.constFind(eventNumber);
+  return (it!=eventInfoIdxsByNumber.constEnd()) ?
+    eventInfos.at(it.value()) : eventInfoOf(QString::number(eventNumber));
 }
 
 /**************************************************************************/
@@ -457,6 +721,46 @@ double EventsDB::gregorianDay(const QString& dateTimeStr)
   return gd;
 }
 
+/**************************************************************************/
+RTableRow EventsDB::rowOf(int eventNumber)
+/**************************************************************************/
+/*!
+
+  \brief \return The row of BODC event number \a eventNumber, or an
+  empty row if the event does not exist.
+
+*/
+{
+  QHash<int,int>::ConstIterator it=eventInfoIdxsByNumber.constFind(eventNumber);
+  return (it!=eventInfoIdxsByNumber.constEnd()) ?
+    eventRows.at(it.value()) : value(QString::number(eventNumber));
+}
+
+/**************************************************************************/
+void EventsDB::setColumnIndexes()
+/**************************************************************************/
+/*!
+
+  \brief Determines the indexes of the columns used by this class.
+
+*/
+{
+  idxCruise=columnIndexOf("CRUISE");
+  idxStation=columnIndexOf("STATION");
+  idxEventNumber=columnIndexOf("BODC_EVENT_NUMBER");
+  idxCastIdentifier=columnIndexOf("CAST_IDENTIFIER");
+  idxSamplingDevice=columnIndexOf("SAMPLING_DEVICE");
+  idxStartTimeDate=columnIndexOf("EVENT_START_TIME_DATE");
+  idxEndTimeDate=columnIndexOf("EVENT_END_TIME_DATE");
+  idxStartLongitude=columnIndexOf("EVENT_START_LONGITUDE");
+  idxEndLongitude=columnIndexOf("EVENT_END_LONGITUDE");
+  idxStartLatitude=columnIndexOf("EVENT_START_LATITUDE");
+  idxEndLatitude=columnIndexOf("EVENT_END_LATITUDE");
+  idxLongitude=columnIndexOf("LONGITUDE");
+  idxLatitude=columnIndexOf("LATITUDE");
+  idxBottomDepth=columnIndexOf("BOTTOM DEPTH [M]");
+}
+
 /**************************************************************************/
 QStringList EventsDB::spreadsheetHeader()
 /**************************************************************************/
@@ -10,8 +10,10 @@
 **
 ****************************************************************************/
 
+#include <QHash>
 #include <QString>
 #include <QStringList>
+#include <QVector>
 
 #include "globalDefines.h"
 #include "RTable.h"
@@ -63,30 +65,44 @@ class EventsDB : public RTable
 {
 public:
   EventsDB(const QString& fn,const QString& keyLabel,QChar splitChar);
+  EventsDB(QDataStream& in);
 
   void autoCorrectStationLabels();
-  StationList collateStations(const QStringList& eventNumbers,
+  StationList collateStations(const QVector<int>& eventNumbers,
                               double distanceTolerance,
                               double timeTolerance,
                               EventsDB *eventsDB);
-  StationList collateStationsByProximity(const QStringList& eventNumbers,
+  StationList collateStationsByProximity(const QVector<int>& eventNumbers,
                                          double distanceTolerance,
                                          double timeTolerance,
                                          StationList& stLstByStLbl,
                                          EventsDB *eventsDB);
-  StationList collateStationsByStationLabel(const QStringList& eventNumbers,
-                                            QStringList& noNameEventNumbers,
+  StationList collateStationsByStationLabel(const QVector<int>& eventNumbers,
+                                            QVector<int>& noNameEventNumbers,
                                             EventsDB *eventsDB);
+  bool containsEvent(int eventNumber) const
+  { return eventInfoIdxsByNumber.contains(eventNumber); }
+  void decodeEventInfos();
   static void diagnoseEventCorrections();
   EventInfo eventInfoOf(const RTableRow& ii);
   EventInfo eventInfoOf(const QString& eventNumberStr);
+  EventInfo eventInfoOf(int eventNumber);
   double gregorianDay(const QString& dateTimeStr);
+  RTableRow rowOf(int eventNumber);
+  void setColumnIndexes();
   QStringList spreadsheetHeader();
   QStringList uniqueValuesFor(const QStringList& eventNumbers,int idx);
 
   int idxCruise,idxStation,idxEventNumber,idxCastIdentifier,idxSamplingDevice;
   int idxStartTimeDate,idxEndTimeDate,idxLongitude,idxLatitude,idxBottomDepth;
   int idxStartLongitude,idxEndLongitude,idxStartLatitude,idxEndLatitude;
+
+private:
+  QVector<EventInfo> eventInfos;      //!< decoded event infos
+  QVector<RTableRow> eventRows;       //!< rows of the decoded events
+  QHash<QString,int> eventInfoIdxs;   //!< index into eventInfos by event number
+  QHash<int,int> eventInfoIdxsByNumber;
+  //!< index into eventInfos by integer event number
 };
 
 
@@ -0,0 +1,185 @@
+/****************************************************************************
+**
+** Copyright (C) 2025 Reiner Schlitzer. All rights reserved.
+**
+** This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+** WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+**
+****************************************************************************/
+
+#include "InfoFileRegistry.h"
+
+#include <QFile>
+#include <QMutexLocker>
+#include <QStringList>
+
+
+/**************************************************************************/
+bool InfoFileRegistry::claim(const QString& path,const QString& key)
+/**************************************************************************/
+/*!
+
+  \brief Claims the generation of info file \a path with content key
+  \a key.
+
+  \return \c true if the caller has to generate the contents and pass
+  them to setContents(), or \c false if the contents are generated by
+  somebody else.
+
+*/
+{
+  QMutexLocker locker(&mutex);
+  const QString ek=entryKey(path,key);
+  if (contentsByEntry.contains(ek)) return false;
+  contentsByEntry.insert(ek,QByteArray());
+  return true;
+}
+
+/**************************************************************************/
+bool InfoFileRegistry::contains(const QString& path,const QString& key) const
+/**************************************************************************/
+/*!
+
+  \brief \return \c true if info file \a path with content key \a key
+  has been claimed, or \c false otherwise.
+
+*/
+{
+  QMutexLocker locker(&mutex);
+  return contentsByEntry.contains(entryKey(path,key));
+}
+
+/**************************************************************************/
+void InfoFileRegistry::setContents(const QString& path,const QString& key,
+                                   const QByteArray& contents)
+/**************************************************************************/
+/*!
+
+  \brief Sets the contents of info file \a path with content key \a
+  key to \a contents.
+
+*/
+{
+  QMutexLocker locker(&mutex);
+  contentsByEntry.insert(entryKey(path,key),contents);
+}
+
+/**************************************************************************/
+void InfoFileRegistry::use(const QString& path,const QString& key)
+/**************************************************************************/
+/*!
+
+  \brief Records a reference to info file \a path with content key \a
+  key.
+
+  Must be called in output order from one thread only.
+
+*/
+{
+  keysByPath.insert(path,key);
+}
+
+/**************************************************************************/
+int InfoFileRegistry::write(bool packed,bool skipUnchanged)
+/**************************************************************************/
+/*!
+
+  \brief Writes all used info files.
+
+  If \a packed is \c true, the files are packed into one container per
+  directory (see writePacked()). If \a skipUnchanged is \c true,
+  existing files with identical contents are not rewritten, so that
+  their time stamps are preserved on rebuilds.
+
+  \return The number of files written.
+
+*/
+{
+  QMutexLocker locker(&mutex);
+  if (packed) return writePacked(skipUnchanged);
+
+  int writeCount=0; QMap<QString,QString>::ConstIterator it;
+  for (it=keysByPath.constBegin(); it!=keysByPath.constEnd(); ++it)
+    if (writeFile(it.key(),contentsByEntry.value(entryKey(it.key(),it.value())),
+                  skipUnchanged)) ++writeCount;
+
+  return writeCount;
+}
+
+/**************************************************************************/
+bool InfoFileRegistry::writeFile(const QString& fn,const QByteArray& contents,
+                                 bool skipUnchanged)
+/**************************************************************************/
+/*!
+
+  \brief Writes \a contents to file \a fn. If \a skipUnchanged is \c
+  true and \a fn already has contents \a contents, the file is not
+  rewritten.
+
+  \return \c true if the file was written, or \c false otherwise.
+
+*/
+{
+  QFile f(fn);
+  if (skipUnchanged && f.size()==contents.size() && f.open(QIODevice::ReadOnly))
+    {
+      bool isUnchanged=(f.readAll()==contents); f.close();
+      if (isUnchanged) return false;
+    }
+
+  return f.open(QIODevice::WriteOnly) && f.write(contents)==contents.size();
+}
+
+/**************************************************************************/
+int InfoFileRegistry::writePacked(bool skipUnchanged)
+/**************************************************************************/
+/*!
+
+  \brief Packs all used info files of a directory into the two files
+  infos.pack and infos.manifest in that directory.
+
+  infos.pack is the concatenation of the file contents. infos.manifest
+  is a tab separated table with columns NAME, OFFSET and SIZE, holding
+  the file name (as used in the lf: links), the byte offset into
+  infos.pack and the byte size of every packed file. The lf: links
+  of the data are not changed, so they are only resolved by external
+  tools reading infos.manifest; ODV itself cannot open them.
+  Individual files replaced by the container, for instance from an
+  earlier unpacked build, are removed, so that the links never open
+  stale pages.
+
+  Must be called with the mutex locked.
+
+  \return The number of container files written.
+
+*/
+{
+  QMap<QString,QStringList> namesByDir; QString path; int i;
+  QMap<QString,QString>::ConstIterator it;
+  for (it=keysByPath.constBegin(); it!=keysByPath.constEnd(); ++it)
+    {
+      path=it.key(); i=path.lastIndexOf('/');
+      namesByDir[path.left(i+1)].append(path.mid(i+1));
+    }
+
+  int n,writeCount=0; QString dir,name; QByteArray pack,manifest,contents;
+  QMap<QString,QStringList>::ConstIterator itD;
+  for (itD=namesByDir.constBegin(); itD!=namesByDir.constEnd(); ++itD)
+    {
+      dir=itD.key(); const QStringList& names=itD.value(); n=names.size();
+      pack.clear(); manifest="NAME\tOFFSET\tSIZE\n";
+      for (i=0; i<n; ++i)
+        {
+          name=names.at(i);
+          contents=contentsByEntry.value(entryKey(dir+name,keysByPath.value(dir+name)));
+          manifest+=QString("%1\t%2\t%3\n").arg(name).arg(pack.size())
+            .arg(contents.size()).toUtf8();
+          pack+=contents;
+          QFile::remove(dir+name);
+        }
+      if (writeFile(dir+"infos.pack",pack,skipUnchanged)) ++writeCount;
+      if (writeFile(dir+"infos.manifest",manifest,skipUnchanged)) ++writeCount;
+    }
+
+  return writeCount;
+}
@@ -0,0 +1,68 @@
+#ifndef INFOFILEREGISTRY_H
+#define INFOFILEREGISTRY_H
+
+/****************************************************************************
+**
+** Copyright (C) 2025 Reiner Schlitzer. All rights reserved.
+**
+** This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+** WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+**
+****************************************************************************/
+
+#include <QByteArray>
+#include <QHash>
+#include <QMap>
+#include <QMutex>
+#include <QString>
+
+
+/**************************************************************************/
+class InfoFileRegistry
+/**************************************************************************/
+/*!
+
+  \brief Product wide registry of the HTML info files referenced by
+  the data of one or more ODV spreadsheet files.
+
+  An info file is identified by its path and a content key, which
+  determines the file contents (the extended names of the contributing
+  parameters). The contents of every distinct (path, key) pair are
+  generated only once: the first caller of claim() generates them and
+  passes them to setContents().
+
+  use() must be called for every reference in output order. If the
+  same path is used with different keys, the last use wins, exactly as
+  if every reference had rewritten the file. write() finally writes
+  every used file once, either as individual file or packed into one
+  container per directory (see writePacked()).
+
+  claim(), contains() and setContents() may be called concurrently
+  from different threads.
+
+*/
+{
+public:
+  bool claim(const QString& path,const QString& key);
+  bool contains(const QString& path,const QString& key) const;
+  int fileCount() const { return keysByPath.size(); }
+  void setContents(const QString& path,const QString& key,
+                   const QByteArray& contents);
+  void use(const QString& path,const QString& key);
+  int write(bool packed=false,bool skipUnchanged=true);
+
+private:
+  static QString entryKey(const QString& path,const QString& key)
+  { return path+QChar('\n')+key; }
+  static bool writeFile(const QString& fn,const QByteArray& contents,
+                        bool skipUnchanged);
+  int writePacked(bool skipUnchanged);
+
+  mutable QMutex mutex;                   //!< protects contentsByEntry
+  QHash<QString,QByteArray> contentsByEntry;
+  //!< file contents by path and content key (see entryKey())
+  QMap<QString,QString> keysByPath;       //!< content key of last use by path
+};
+
+
+#endif   // INFOFILEREGISTRY_H
@@ -0,0 +1,186 @@
+/****************************************************************************
+**
+** Copyright (C) 2025 Reiner Schlitzer. All rights reserved.
+**
+** This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+** WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+**
+****************************************************************************/
+
+#include "InputSnapshot.h"
+
+#include <limits.h>
+
+#include <QDir>
+#include <QFileInfo>
+#include <QSysInfo>
+
+#include "globalVars.h"
+#include "globalFunctions.h"
+
+
+/**************************************************************************/
+InputSnapshot::InputSnapshot(const QString& fn,const QStringList& inputFiles)
+  : filePath(fn),mapPtr(0)
+/**************************************************************************/
+/*!
+
+  \brief Creates an InputSnapshot object for snapshot file \a fn and
+  input files \a inputFiles.
+
+  The signatures of all input files are determined immediately (see
+  fileSignature()). \a inputFiles must contain absolute paths.
+
+*/
+{
+  if (useInputSnapshots) signature=signatureOf(inputFiles);
+}
+
+/**************************************************************************/
+InputSnapshot::~InputSnapshot()
+/**************************************************************************/
+/*!
+
+  \brief Destroys the InputSnapshot object. A snapshot file being
+  created is discarded unless commit() was called.
+
+*/
+{
+  close();
+}
+
+/**************************************************************************/
+void InputSnapshot::close()
+/**************************************************************************/
+/*!
+
+  \brief Releases the memory mapping of a loaded snapshot file.
+
+  Call this function after all objects have been read.
+
+*/
+{
+  if (ds.device()!=&saveFile) { ds.setDevice(0); ds.resetStatus(); }
+  if (mapBuffer.isOpen()) mapBuffer.close();
+  mapBytes.clear();
+  if (mapPtr) { mapFile.unmap(mapPtr); mapPtr=0; }
+  if (mapFile.isOpen()) mapFile.close();
+}
+
+/**************************************************************************/
+bool InputSnapshot::commit()
+/**************************************************************************/
+/*!
+
+  \brief Finishes the snapshot file started with create().
+
+  The snapshot file is replaced only if all objects were written
+  successfully.
+
+  \return \c true if successful, or \c false otherwise.
+
+*/
+{
+  if (ds.device()!=&saveFile) return false;
+
+  bool ok=(ds.status()==QDataStream::Ok);
+  ds.setDevice(0); ds.resetStatus();
+  if (!ok) saveFile.cancelWriting();
+  return saveFile.commit();
+}
+
+/**************************************************************************/
+bool InputSnapshot::create()
+/**************************************************************************/
+/*!
+
+  \brief Starts writing a new snapshot file and writes the file
+  header.
+
+  Write the objects to stream() and call commit() afterwards. The
+  existing snapshot file remains untouched until commit().
+
+  \return \c true if successful, or \c false otherwise.
+
+*/
+{
+  close();
+  if (!useInputSnapshots || ds.device()) return false;
+
+  QDir().mkpath(QFileInfo(filePath).absolutePath());
+  saveFile.setFileName(filePath);
+  if (!saveFile.open(QIODevice::WriteOnly)) return false;
+
+  ds.setDevice(&saveFile); ds.setVersion(QDataStream::Qt_5_0);
+  ds << (quint32) magicNumber << (quint32) formatVersion << signature;
+  return ds.status()==QDataStream::Ok;
+}
+
+/**************************************************************************/
+bool InputSnapshot::load()
+/**************************************************************************/
+/*!
+
+  \brief Memory maps the snapshot file and validates its header.
+
+  On success, the objects can be read from stream() in the order
+  they were written.
+
+  \return \c true if the snapshot file exists, has the current format
+  version and was created from input files with identical signatures,
+  or \c false otherwise.
+
+*/
+{
+  close();
+  if (!useInputSnapshots || ds.device()) return false;
+
+  mapFile.setFileName(filePath);
+  if (!mapFile.exists() || !mapFile.open(QIODevice::ReadOnly)) return false;
+
+  /* map the file; files too large for QByteArray are read directly */
+  qint64 n=mapFile.size();
+  if (n<=0) { close(); return false; }
+  if (n<=INT_MAX && (mapPtr=mapFile.map(0,n))!=0)
+    {
+      mapBytes=QByteArray::fromRawData((const char*) mapPtr,(int) n);
+      mapBuffer.setBuffer(&mapBytes); mapBuffer.open(QIODevice::ReadOnly);
+      ds.setDevice(&mapBuffer);
+    }
+  else
+    ds.setDevice(&mapFile);
+
+  /* validate the header */
+  ds.setVersion(QDataStream::Qt_5_0);
+  quint32 magic,version; QString sig;
+  ds >> magic >> version;
+  if (ds.status()==QDataStream::Ok &&
+      magic==(quint32) magicNumber && version==(quint32) formatVersion)
+    ds >> sig;
+
+  bool ok=(ds.status()==QDataStream::Ok && !sig.isEmpty() && sig==signature);
+  if (!ok) close();
+  return ok;
+}
+
+/**************************************************************************/
+QString InputSnapshot::signatureOf(const QStringList& inputFiles)
+/**************************************************************************/
+/*!
+
+  \brief Constructs the combined signature of all files in \a
+  inputFiles (see fileSignature()).
+
+  The signature also contains the build ABI, since numeric data are
+  stored in native byte order.
+
+  \return The constructed signature.
+
+*/
+{
+  QStringList sl; sl.append(QSysInfo::buildAbi());
+  int i,n=inputFiles.size();
+  for (i=0; i<n; ++i)
+    sl.append(inputFiles.at(i)+" | "+fileSignature(inputFiles.at(i)));
+  return sl.join("\n");
+}
@@ -0,0 +1,70 @@
+#ifndef INPUTSNAPSHOT_H
+#define INPUTSNAPSHOT_H
+
+/****************************************************************************
+**
+** Copyright (C) 2025 Reiner Schlitzer. All rights reserved.
+**
+** This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+** WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+**
+****************************************************************************/
+
+#include <QBuffer>
+#include <QByteArray>
+#include <QDataStream>
+#include <QFile>
+#include <QSaveFile>
+#include <QString>
+#include <QStringList>
+
+
+/**************************************************************************/
+class InputSnapshot
+/**************************************************************************/
+/*!
+
+  \brief Binary snapshot of loaded input objects.
+
+  A snapshot file starts with a magic number, the format version and
+  the signatures of all input files the snapshot was created from. The
+  objects follow in the order in which they were written. load()
+  memory maps the snapshot file and succeeds only if the stored
+  signatures match the current input files. Objects are then read
+  from stream() using their QDataStream constructors.
+
+  Increment formatVersion whenever the binary layout of any snapshot
+  object changes.
+
+*/
+{
+public:
+  InputSnapshot(const QString& fn,const QStringList& inputFiles);
+  ~InputSnapshot();
+
+  void close();
+  bool commit();
+  bool create();
+  bool isIntact() const { return ds.status()==QDataStream::Ok; }
+  bool load();
+  QDataStream& stream() { return ds; }
+
+private:
+  Q_DISABLE_COPY(InputSnapshot)
+
+  enum { magicNumber=0x49445053,formatVersion=1 };
+
+  static QString signatureOf(const QStringList& inputFiles);
+
+  QString filePath;    //!< path of the snapshot file
+  QString signature;   //!< signatures of all input files
+  QFile mapFile;       //!< snapshot file when loading
+  uchar *mapPtr;       //!< start of the memory mapped snapshot file
+  QByteArray mapBytes; //!< raw data wrapper of the mapped file contents
+  QBuffer mapBuffer;   //!< read device on mapBytes
+  QSaveFile saveFile;  //!< snapshot file when creating
+  QDataStream ds;      //!< stream for reading or writing the objects
+};
+
+
+#endif   // INPUTSNAPSHOT_H
@@ -9,13 +9,110 @@
 
 #include "Params.h"
 
+#include <QDataStream>
 #include <QDir>
 #include <QFile>
+#include <QReadWriteLock>
+#include <QRunnable>
+#include <QScopedPointer>
+#include <QSemaphore>
 #include <QTextStream>
+#include <QThreadPool>
 
 #include "globalVars.h"
 #include "globalFunctions.h"
 #include "EventData.h"
+#include "InfoFileRegistry.h"
+#include "RRecordWriter.h"
+
+
+/**************************************************************************/
+class EventDataContext
+/**************************************************************************/
+/*!
+
+  \brief Read-only inputs shared by all EventDataWorker objects of one
+  ParamSet::writeDataAsSpreadsheet() call.
+
+*/
+{
+public:
+  StationList *stationList;
+  DatasetInfos *datasetInfos;
+  CruisesDB *cruisesDB;
+  ParamSet *paramSet;
+  DataItemList *dataItemList;
+  RTable *docuByExtPrmName;
+  RTable *bioGeotracesInfos;
+  RTable *piInfosByName;
+  UnitConverter *unitConverter;
+  QMap<char,QString> *bottleFlagDescr;
+  QString infosDir;
+  ParamSet *uParamSet;  //!< unified parameter set, or NULL
+  QString uInfosDir;    //!< info file directory of the unified parameter set
+  InfoFileRegistry *infoFiles; //!< product wide info file registry
+  QVector<QPair<int,int> > jobs; //!< station and event indexes in output order
+};
+
+/**************************************************************************/
+class EventDataWorker : public QRunnable
+/**************************************************************************/
+/*!
+
+  \brief Assembles the EventData objects of a contiguous range of jobs
+  and collects their spreadsheet lines and info file uses.
+
+  If the context has a unified parameter set, every EventData object
+  is switched to it after the non-unified lines are collected, and the
+  unified lines are collected in uLines.
+
+  done is released when the results are available.
+
+*/
+{
+public:
+  EventDataWorker(const EventDataContext *context,int firstJob,int endJob)
+    : ctx(context),first(firstJob),end(endJob) { setAutoDelete(false); }
+
+  int endJob() const { return end; }
+
+  void run()
+  {
+    int i,k,n,stationIdx=-1; Station station; QStringList sl;
+    for (i=first; i<end; ++i)
+      {
+        const QPair<int,int>& job=ctx->jobs.at(i);
+        if (job.first!=stationIdx)
+          { stationIdx=job.first; station=ctx->stationList->at(stationIdx); }
+
+        EventData ed(&station,job.second,ctx->datasetInfos,ctx->cruisesDB,
+                     ctx->paramSet,ctx->dataItemList,ctx->docuByExtPrmName,
+                     ctx->bioGeotracesInfos,ctx->piInfosByName,
+                     ctx->unitConverter,ctx->bottleFlagDescr,ctx->infosDir);
+        ed.infoFileRegistryPtr=ctx->infoFiles; ed.infoFileUsesPtr=&infoFileUses;
+        sl=ed.spreadsheetDataLines(); n=sl.size();
+        for (k=0; k<n; ++k)
+          { lines.append(sl.at(k).toUtf8()); lines.append('\n'); }
+        if (!ctx->uParamSet) continue;
+
+        ed.switchToUnifiedParams(ctx->uParamSet,ctx->uInfosDir);
+        sl=ed.spreadsheetDataLines(); n=sl.size();
+        for (k=0; k<n; ++k)
+          { uLines.append(sl.at(k).toUtf8()); uLines.append('\n'); }
+      }
+    done.release();
+  }
+
+  QByteArray lines;  //!< UTF-8 encoded spreadsheet lines
+  QByteArray uLines; //!< UTF-8 encoded spreadsheet lines, unified parameters
+  QList<QPair<QString,QString> > infoFileUses; //!< info file paths and content keys
+  QSemaphore done;  //!< released when run() has finished
+
+private:
+  const EventDataContext *ctx; //!< pointer to the shared inputs
+  int first;                   //!< index of first job
+  int end;                     //!< index after last job
+};
 
 
 /**************************************************************************/
@@ -204,6 +301,54 @@ IdpDataType Param::dataType(ParamSamplingSystem prmSmplSytem)
   }
 }
 
+/**************************************************************************/
+ExtendedNameInfo Param::extendedNameInfo(const QString& extPrmName)
+/**************************************************************************/
+/*!
+
+  \brief Decomposes the extended parameter name \a extPrmName into
+  parameter name and barcode, and determines unified name, sampling
+  system and data type of the parameter name.
+
+  Results are cached by extended name, so that every distinct name is
+  decomposed only once. This function is thread-safe.
+
+  \return The decomposition.
+
+*/
+{
+  static QHash<QString,ExtendedNameInfo> infosByExtName;
+  static QReadWriteLock lock;
+
+  {
+    QReadLocker locker(&lock);
+    QHash<QString,ExtendedNameInfo>::ConstIterator it=
+      infosByExtName.constFind(extPrmName);
+    if (it!=infosByExtName.constEnd()) return it.value();
+  }
+
+  ExtendedNameInfo ei; int i,j;
+  if ((i=extPrmName.indexOf("::"))>-1)
+    {
+      ei.name=extPrmName.left(i); j=extPrmName.indexOf("::",i+2);
+      ei.barcode=extPrmName.mid(i+2,(j>-1) ? j-i-2 : -1);
+    }
+  else
+    ei.name=extPrmName;
+
+  ei.samplingSystem=samplingSystem(ei.name);
+  ei.samplingSuffix=samplingSystemStr(ei.samplingSystem);
+  ei.dataType=dataType(ei.samplingSystem);
+  ei.unifiedName=ei.name;
+  if (ei.dataType==SeawaterDT && ei.samplingSystem!=SensorSS &&
+      (i=ei.name.indexOf(ei.samplingSuffix))>-1)
+    ei.unifiedName=ei.name.left(i);
+
+  QWriteLocker locker(&lock);
+  infosByExtName.insert(extPrmName,ei);
+  return ei;
+}
+
 /**************************************************************************/
 QString Param::fullLabel()
 /**************************************************************************/
@@ -277,13 +422,15 @@ QString Param::paramNameFromExtendedName(const QString& extPrmName,
   If \a barcode is not NULL on entry, returns the barcode part of the
   extended name in \a barcode.
 
+  Uses the cached decomposition of extendedNameInfo().
+
   \return The extracted name label.
 
 */
 {
-  QStringList sl=extPrmName.split("::");
-  if (barcode) *barcode=sl.at(1);
-  return sl.at(0);
+  ExtendedNameInfo ei=extendedNameInfo(extPrmName);
+  if (barcode) *barcode=ei.barcode;
+  return ei.name;
 }
 
 /**************************************************************************/
@@ -399,8 +546,17 @@ QString Param::unifiedNameLabel(const QString& prmName,QString& samplingSuffix)
 
   \note \c _SENSOR parameter names are returned unchanged.
 
+  Plain parameter names use the cached decomposition of
+  extendedNameInfo().
+
 */
 {
+  if (!prmName.contains("::"))
+    {
+      ExtendedNameInfo ei=extendedNameInfo(prmName);
+      samplingSuffix=ei.samplingSuffix; return ei.unifiedName;
+    }
+
   ParamSamplingSystem samplingSystem=Param::samplingSystem(prmName);
   samplingSuffix=Param::samplingSystemStr(samplingSystem);
   if (dataType(samplingSystem)!=SeawaterDT) return prmName;
@@ -634,6 +790,58 @@ ParamGroup ParamGroupList::paramGroupFor(const QString &samplerName,
   return (i>-1) ? prmGroups.at(i) : ParamGroup();
 }
 
+/**************************************************************************/
+void ParamGroupList::readFrom(QDataStream& in)
+/**************************************************************************/
+/*!
+
+  \brief Replaces the contents with the parameter groups read from
+  binary stream \a in (see writeTo()).
+
+*/
+{
+  prmGroups.clear();
+  qint32 i,j,n,m,id,dType,smplSystem;
+  in >> n;
+  for (i=0; i<n && in.status()==QDataStream::Ok; ++i)
+    {
+      ParamGroup g; in >> g.keyWord >> g.sampler >> g.category >> m;
+      for (j=0; j<m && in.status()==QDataStream::Ok; ++j)
+        {
+          Param p;
+          in >> id >> p.name >> p.units >> p.description >> dType >> smplSystem;
+          p.id=id; p.dType=(IdpDataType) dType;
+          p.smplSystem=(ParamSamplingSystem) smplSystem;
+          g.prmLst.append(p);
+        }
+      prmGroups.append(g);
+    }
+}
+
+/**************************************************************************/
+void ParamGroupList::writeTo(QDataStream& out) const
+/**************************************************************************/
+/*!
+
+  \brief Writes all parameter groups to binary stream \a out.
+
+*/
+{
+  int i,j,n=prmGroups.size(),m;
+  out << (qint32) n;
+  for (i=0; i<n; ++i)
+    {
+      const ParamGroup& g=prmGroups.at(i); m=g.prmLst.size();
+      out << g.keyWord << g.sampler << g.category << (qint32) m;
+      for (j=0; j<m; ++j)
+        {
+          const Param& p=g.prmLst.at(j);
+          out << (qint32) p.id << p.name << p.units << p.description
+              << (qint32) p.dType << (qint32) p.smplSystem;
+        }
+    }
+}
+
 
 
 /**************************************************************************/
@@ -655,26 +863,7 @@ ParamDB::ParamDB(const QString paramListDir)
 
 */
 {
-  /* string replacements for keywords and group/subgroup names in parameter files */
-  replacer.append("Bottles","Bottle");
-  replacer.append("Pumps","Pump");
-  replacer.append("Towed fish","Towed Fish");
-  replacer.append("Boat-pump","Boat Pump");
-  replacer.append("Meltpond-pump","Meltpond Pump");
-  replacer.append("Ship's underway","Ship's Underway");
-  replacer.append("Subice-pump","Subice Pump");
-  replacer.append("Rain-auto","Rain Auto");
-  replacer.append("Rain-man","Rain Man");
-  replacer.append("Snow-auto","Snow Auto");
-  replacer.append("Snow-man","Snow Man");
-  replacer.append("Snow-grab","Snow Grab");
-  replacer.append("Aerosols-hivol","Aerosols Hivol");
-  replacer.append("Aerosols-lowvol","Aerosols Lowvol");
-  replacer.append("Aerosols-size_fractionated","Aerosols Size Fractionated");
-  replacer.append("Ice-corer","Ice Corer");
-  replacer.append("Ice-grab","Ice Grab");
-  replacer.append("and inert gases","and Inert Gases");
-  replacer.append("and water isotopes","and Water Isotopes");
+  setupReplacer();
 
   /* load all parameter lists */
   load(inpDir+"HYDROGRAPHY_AND_BIOGEOCHEMISTRY_parameters.txt");
@@ -689,6 +878,22 @@ ParamDB::ParamDB(const QString paramListDir)
   load(inpDir+"LIGAND_parameters.txt");
 }
 
+/**************************************************************************/
+ParamDB::ParamDB(QDataStream& in)
+/**************************************************************************/
+/*!
+
+  \brief Constructs a ParamDB object and reads the parameter groups
+  from binary stream \a in (see writeTo()).
+
+*/
+{
+  setupReplacer();
+
+  in >> inpDir;
+  prmGroupList.readFrom(in);
+}
+
 /**************************************************************************/
 int ParamDB::appendGroup(const QString& keyWord,const QString& samplerName,
                          const QString& prmCategory,QList<Param>& prmLst)
@@ -781,6 +986,37 @@ int ParamDB::load(const QString& fn)
 }
 
 
+/**************************************************************************/
+void ParamDB::setupReplacer()
+/**************************************************************************/
+/*!
+
+  \brief Sets up the string replacements for keywords and
+  group/subgroup names in parameter files.
+
+*/
+{
+  replacer.append("Bottles","Bottle");
+  replacer.append("Pumps","Pump");
+  replacer.append("Towed fish","Towed Fish");
+  replacer.append("Boat-pump","Boat Pump");
+  replacer.append("Meltpond-pump","Meltpond Pump");
+  replacer.append("Ship's underway","Ship's Underway");
+  replacer.append("Subice-pump","Subice Pump");
+  replacer.append("Rain-auto","Rain Auto");
+  replacer.append("Rain-man","Rain Man");
+  replacer.append("Snow-auto","Snow Auto");
+  replacer.append("Snow-man","Snow Man");
+  replacer.append("Snow-grab","Snow Grab");
+  replacer.append("Aerosols-hivol","Aerosols Hivol");
+  replacer.append("Aerosols-lowvol","Aerosols Lowvol");
+  replacer.append("Aerosols-size_fractionated","Aerosols Size Fractionated");
+  replacer.append("Ice-corer","Ice Corer");
+  replacer.append("Ice-grab","Ice Grab");
+  replacer.append("and inert gases","and Inert Gases");
+  replacer.append("and water isotopes","and Water Isotopes");
+}
+
 /**************************************************************************/
 void ParamDB::writeDiagnostics(const QString outDir)
 /**************************************************************************/
@@ -803,6 +1039,19 @@ void ParamDB::writeDiagnostics(const QString outDir)
     prmGroupList.categoriesFor(CryosphereDT),true);
 }
 
+/**************************************************************************/
+void ParamDB::writeTo(QDataStream& out) const
+/**************************************************************************/
+/*!
+
+  \brief Writes the parameter groups to binary stream \a out.
+
+*/
+{
+  out << inpDir;
+  prmGroupList.writeTo(out);
+}
+
 /**************************************************************************/
 /**************************************************************************/
 
@@ -891,9 +1140,58 @@ ParamSet::ParamSet(IdpDataType dataType,ParamDB *params,
         }
     }
 
+    buildParamIndex();
     if (unifySamplingSystems) unifyParameters(dataType);
 }
 
+/**************************************************************************/
+void ParamSet::appendEmptyParamFields(QString& s,int columnCount) const
+/**************************************************************************/
+/*!
+
+  \brief Appends the spreadsheet fields of \a columnCount parameters
+  without data to \a s.
+
+*/
+{
+  if (columnCount>0)
+    s.append(emptyPrmFields.constData(),columnCount*emptyPrmFieldsSize);
+}
+
+/**************************************************************************/
+void ParamSet::buildParamIndex()
+/**************************************************************************/
+/*!
+
+  \brief Builds the parameter name to parameter ID index \a
+  prmIdsByName and the parameter name to spreadsheet column index \a
+  prmColumnsByName from \a prms.
+
+  If several parameters share the same name, the lowest ID is
+  indexed in \a prmIdsByName.
+
+  Also builds \a emptyPrmFields, the spreadsheet fields (value,
+  standard deviation, quality flag and info) of all parameters for a
+  sample without data (see EventData::getValues()).
+
+*/
+{
+  prmIdsByName.clear(); prmIdsByName.reserve(prms.size());
+  prmColumnsByName.clear(); prmColumnsByName.reserve(prms.size());
+
+  QMap<int,Param>::ConstIterator it; int column=0;
+  for (it=prms.constBegin(); it!=prms.constEnd(); ++it,++column)
+    {
+      if (!prmIdsByName.contains(it.value().name))
+        prmIdsByName.insert(it.value().name,it.key());
+      prmColumnsByName[it.value().name].append(column);
+    }
+
+  const QString emptyFields="\t\t\t9\t";
+  emptyPrmFieldsSize=emptyFields.size();
+  emptyPrmFields=emptyFields.repeated(prms.size());
+}
+
 /**************************************************************************/
 QString ParamSet::collectionDescription()
 /**************************************************************************/
@@ -1045,26 +1343,6 @@ QString ParamSet::paramFullLabel(int prmID)
   return QString();
 }
 
-/**************************************************************************/
-int ParamSet::paramIdFor(const QString& prmName)
-/**************************************************************************/
-/*!
-
-  \return The IDP parameter id of the parameter with name label \a
-  prmName, or \c -1 if there is no such parameter.
-
-*/
-{
-  QMap<int,Param>::ConstIterator it=prms.constBegin();
-
-  while (it!=prms.constEnd())
-    {
-      if (it.value().name==prmName) return it.key();
-      ++it;
-    }
-  return -1;
-}
-
 /**************************************************************************/
 QString ParamSet::paramName(int prmID)
 /**************************************************************************/
@@ -1158,7 +1436,7 @@ void ParamSet::unifyParameters(IdpDataType dataType)
           uPrmUnitsByName.insert(prm.name,prm.units);
         }
     }
-  prms=uPrmsById; prmUnitsByName=uPrmUnitsByName;
+  prms=uPrmsById; prmUnitsByName=uPrmUnitsByName; buildParamIndex();
 
   /* loop over all existing parameter groups and unify */
   const QStringList categories=prmGroupList.categoriesFor(dataType);
@@ -1192,33 +1470,136 @@ void ParamSet
                          RTable *piInfosByName,RTable *keyVarsByDataVar,
                          UnitConverter *unitConverter,
                          QMap<char,QString> *bottleFlagDescr,
-                         const QString& dir,const QString& fn)
+                         const QString& dir,const QString& fn,
+                         int threadCount)
 /**************************************************************************/
 /*!
 
   \brief Writes the IDP data of this data type to file \a fn in
   directory \a dir.
 
+  See writeDataAsSpreadsheets() for details.
+
+*/
+{
+  writeDataAsSpreadsheets(NULL,stationList,cruisesDB,docuByExtPrmName,
+                          bioGeotracesInfos,piInfosByName,keyVarsByDataVar,NULL,
+                          unitConverter,bottleFlagDescr,dir,QString(),fn,
+                          threadCount);
+}
+
+/**************************************************************************/
+void ParamSet
+::writeDataAsSpreadsheets(ParamSet *uParamSet,StationList *stationList,
+                          CruisesDB *cruisesDB,RTable *docuByExtPrmName,
+                          RTable *bioGeotracesInfos,RTable *piInfosByName,
+                          RTable *keyVarsByDataVar,RTable *keyVarsByDataVarU,
+                          UnitConverter *unitConverter,
+                          QMap<char,QString> *bottleFlagDescr,
+                          const QString& dir,const QString& uDir,
+                          const QString& fn,int threadCount)
+/**************************************************************************/
+/*!
+
+  \brief Writes the IDP data of this data type to file \a fn in
+  directory \a dir.
+
+  If \a uParamSet is not \c NULL, the data are also written for the
+  unified parameter set \a uParamSet to file \a fn in directory \a
+  uDir, using key variables \a keyVarsByDataVarU. This parameter set
+  must be non-unified, and \a uParamSet must be the unified parameter
+  set of the same data type and data items. Every event is collated
+  only once and is then switched to \a uParamSet (see
+  EventData::switchToUnifiedParams()).
+
+  The events are assembled in parallel using
+  workerThreadCount(threadCount) threads. The output does not depend
+  on the number of threads.
+
+  Every distinct info file is generated and written only once (see
+  InfoFileRegistry). Unchanged info files are not rewritten. If \a
+  packInfoFiles is \c true, the info files are packed into one
+  container (see InfoFileRegistry::writePacked()).
+
 */
 {
-  const QString outFn=dir+fn;
   const QString infosDir=dir+"infos/"; QDir().mkpath(infosDir);
+  const QString uInfosDir=uDir+"infos/";
+  const int eventsPerTask=8; threadCount=workerThreadCount(threadCount);
+  if (uParamSet && unifiedPrms) uParamSet=NULL;
+
+  RRecordWriter out(dir+fn,true);
+  out.write(EventData::spreadsheetHeaderLines(this,keyVarsByDataVar));
+  QScopedPointer<RRecordWriter> uOut;
+  if (uParamSet)
+    {
+      QDir().mkpath(uInfosDir); uOut.reset(new RRecordWriter(uDir+fn,true));
+      uOut->write(EventData::spreadsheetHeaderLines(uParamSet,keyVarsByDataVarU));
+    }
+  int i,j,k,eventCount,stationCount=stationList->size(); Station station;
+  InfoFileRegistry infoFiles;
+
+  if (threadCount<2)
+    {
+      /* loop over all stations and events */
+      for (i=0; i<stationCount; ++i)
+        {
+          station=stationList->at(i); eventCount=station.size();
+          for (j=0; j<eventCount; ++j)
+            {
+              EventData ed(&station,j,datasetInfosPtr,cruisesDB,this,
+                           dataItemListPtr,docuByExtPrmName,
+                           bioGeotracesInfos,piInfosByName,unitConverter,
+                           bottleFlagDescr,infosDir);
+              ed.infoFileRegistryPtr=&infoFiles;
+              out.write(ed.spreadsheetDataLines());
+              if (!uParamSet) continue;
+
+              ed.switchToUnifiedParams(uParamSet,uInfosDir);
+              uOut->write(ed.spreadsheetDataLines());
+            }
+        }
+      infoFiles.write(packInfoFiles);
+      return;
+    }
 
-  appendRecords(outFn,EventData::spreadsheetHeaderLines(this,keyVarsByDataVar),true);
-  int i,j,eventCount,stationCount=stationList->size(); Station station;
-  /* loop over all stations and events */
+  /* assemble the events in worker threads. results are emitted in
+     station and event order, so that the output is identical to the
+     serial loop above. info file uses are recorded in the same order. */
+  EventDataContext ctx;
+  ctx.stationList=stationList; ctx.datasetInfos=datasetInfosPtr;
+  ctx.cruisesDB=cruisesDB; ctx.paramSet=this; ctx.dataItemList=dataItemListPtr;
+  ctx.docuByExtPrmName=docuByExtPrmName; ctx.bioGeotracesInfos=bioGeotracesInfos;
+  ctx.piInfosByName=piInfosByName; ctx.unitConverter=unitConverter;
+  ctx.bottleFlagDescr=bottleFlagDescr; ctx.infosDir=infosDir;
+  ctx.uParamSet=uParamSet; ctx.uInfosDir=uInfosDir; ctx.infoFiles=&infoFiles;
   for (i=0; i<stationCount; ++i)
     {
-      station=stationList->at(i); eventCount=station.size();
-      for (j=0; j<eventCount; ++j)
+      eventCount=stationList->at(i).size();
+      for (j=0; j<eventCount; ++j) ctx.jobs.append(qMakePair(i,j));
+    }
+
+  QThreadPool pool; pool.setMaxThreadCount(threadCount);
+  QList<EventDataWorker*> pending; EventDataWorker *w;
+  int nextJob=0,jobCount=ctx.jobs.size(),maxPending=4*threadCount;
+  while (nextJob<jobCount || !pending.isEmpty())
+    {
+      /* keep the workers busy */
+      while (nextJob<jobCount && pending.size()<maxPending)
         {
-          EventData ed(&station,j,datasetInfosPtr,cruisesDB,this,
-                       dataItemListPtr,docuByExtPrmName,
-                       bioGeotracesInfos,piInfosByName,unitConverter,
-                       bottleFlagDescr,infosDir);
-          appendRecords(outFn,ed.spreadsheetDataLines());
+          w=new EventDataWorker(&ctx,nextJob,qMin(nextJob+eventsPerTask,jobCount));
+          pending.append(w); pool.start(w); nextJob=w->endJob();
         }
+
+      /* emit the results of the oldest task */
+      w=pending.takeFirst(); w->done.acquire();
+      out.writeUtf8(w->lines);
+      if (uParamSet) uOut->writeUtf8(w->uLines);
+      for (k=0; k<w->infoFileUses.size(); ++k)
+        infoFiles.use(w->infoFileUses.at(k).first,w->infoFileUses.at(k).second);
+      delete w;
     }
+  infoFiles.write(packInfoFiles);
 }
 
 /**************************************************************************/
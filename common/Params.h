@@ -10,6 +10,7 @@
 **
 ****************************************************************************/
 
+#include <QHash>
 #include <QList>
 #include <QMap>
 #include <QString>
@@ -46,6 +47,30 @@ public:
 };
 
 
+/**************************************************************************/
+class ExtendedNameInfo
+/**************************************************************************/
+/*!
+
+  \brief Decomposition of an extended parameter name of the form
+  NAME::BARCODE.
+
+  All members except \a barcode are derived from \a name.
+
+*/
+{
+public:
+  ExtendedNameInfo() : samplingSystem(UnknownSS),dataType(UnknownDT) { }
+
+  QString name;           //!< parameter name part
+  QString barcode;        //!< barcode part (empty if there is none)
+  QString unifiedName;    //!< name without sampling system suffix
+  QString samplingSuffix; //!< sampling system suffix of name
+  ParamSamplingSystem samplingSystem; //!< sampling system of name
+  IdpDataType dataType;   //!< data type of name
+};
+
+
 /**************************************************************************/
 class Param
 /**************************************************************************/
@@ -67,6 +92,7 @@ public:
 
   static IdpDataType dataType(const QString& prmName);
   static IdpDataType dataType(ParamSamplingSystem prmSmplSytem);
+  static ExtendedNameInfo extendedNameInfo(const QString& extPrmName);
   QString fullLabel();
   static QString fullLabel(const QString& prmName,const QString& prmUnits);
   static QString nameLabel(const QString& prmLabel);
@@ -134,7 +160,9 @@ public:
   QList<int> indexListForCategory(const QString &prmCategory);
   int indexOf(const QString &samplerName,const QString &prmCategory);
   ParamGroup paramGroupFor(const QString &samplerName,const QString &prmCategory);
+  void readFrom(QDataStream& in);
   int size() { return prmGroups.size(); }
+  void writeTo(QDataStream& out) const;
 
 private:
   QList<ParamGroup> prmGroups;
@@ -152,15 +180,20 @@ class ParamDB
 {
  public:
   ParamDB(const QString paramListDir);
+  ParamDB(QDataStream& in);
 
   int appendGroup(const QString& keyWord,const QString& samplerName,
                   const QString& prmCategory,QList<Param>& prmLst);
   int load(const QString& fn);
   void writeDiagnostics(const QString outDir);
+  void writeTo(QDataStream& out) const;
 
   QString inpDir; //!< directory from which the parameter lists were read
   ParamGroupList prmGroupList; //!< list of parameter groups
   Replacer replacer;
+
+ private:
+  void setupReplacer();
 };
 
 /**************************************************************************/
@@ -179,6 +212,7 @@ class ParamSet
            DataItemList *dataItemList,DatasetInfos *datasetInfos,
            bool unifySamplingSystems=false);
 
+  void appendEmptyParamFields(QString& s,int columnCount) const;
   QString collectionDescription();
   QString collectionField();
   bool contains(int prmID) { return prms.contains(prmID); }
@@ -202,9 +236,13 @@ class ParamSet
   QString paramDescription(int prmID);
   Param paramFor(const QString& prmName);
   QString paramFullLabel(int prmID);
-  int paramIdFor(const QString& prmName);
+  int paramIdFor(const QString& prmName) const
+  { return prmIdsByName.value(prmName,-1); }
   ParamGroupList* paramGroupListPtr() { return &prmGroupList; }
   QMap<int,Param>* paramMapPtr() { return &prms; }
+  QList<int> paramColumnsOf(const QString& prmName) const
+  { return prmColumnsByName.value(prmName); }
+  int paramColumnCount() const { return prms.size(); }
   QString paramName(int prmID);
   QString paramUnits(int prmID);
   QString paramUnitsOf(const QString& prmName);
@@ -214,17 +252,33 @@ class ParamSet
                               RTable *piInfosByName,RTable *keyVarsByDataVar,
                               UnitConverter *unitConverter,
                               QMap<char,QString> *bottleFlagDescr,
-                              const QString& dir,const QString& fn);
+                              const QString& dir,const QString& fn,
+                              int threadCount=0);
+  void writeDataAsSpreadsheets(ParamSet *uParamSet,StationList *stationList,
+                               CruisesDB *cruisesDB,RTable *docuByExtPrmName,
+                               RTable *bioGeotracesInfos,RTable *piInfosByName,
+                               RTable *keyVarsByDataVar,RTable *keyVarsByDataVarU,
+                               UnitConverter *unitConverter,
+                               QMap<char,QString> *bottleFlagDescr,
+                               const QString& dir,const QString& uDir,
+                               const QString& fn,int threadCount=0);
   void writeDescriptions(const QString& dir,const QString& fn);
   void writeParamLists(const QString& dir,const QString& fn);
 
 private:
+  void buildParamIndex();
+
   int maxPrmID;             //!< Largest parameter ID (key in prms)
   IdpDataType type;         //!< Data type
   bool unifiedPrms;         //!< Flag indicating whether parameters are unified or not
 
   ParamGroupList prmGroupList; //!< parameter groups for the specific data type
   QMap<int,Param> prms;        //!< <prmID, Param> container
+  QHash<QString,int> prmIdsByName; //!< <name, prmID> index into prms
+  QHash<QString,QList<int> > prmColumnsByName;
+  //!< <name, spreadsheet column indexes> (column index: position in prms)
+  QString emptyPrmFields;   //!< spreadsheet fields of all parameters without data
+  int emptyPrmFieldsSize;   //!< number of characters per parameter in emptyPrmFields
   QMap<QString,QString> prmUnitsByName; //!< <name, units> container
 
   ODVVarMap metaVars;     //!< ODV meta variables for this data type
@@ -0,0 +1,230 @@
+/****************************************************************************
+**
+** Copyright (C) 2025 Reiner Schlitzer. All rights reserved.
+**
+** This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+** WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+**
+****************************************************************************/
+
+#include "RCsvTokenizer.h"
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/**************************************************************************/
+void RCsvField::stripEnclosingChars(char startChar,char endChar)
+/**************************************************************************/
+/*!
+
+  \brief Strips first and last characters if these are equal to \a
+  startChar and \a endChar.
+
+  Same semantics as the QString version in globalFunctions.
+
+*/
+{
+  if (len>0 && ptr[0]==startChar && ptr[len-1]==endChar)
+    {
+      if (len>1) { ++ptr; len-=2; }
+      else       len=0;
+    }
+}
+
+/**************************************************************************/
+double RCsvField::toDouble(bool *ok) const
+/**************************************************************************/
+/*!
+
+  \brief Converts the field to a double value.
+
+  Plain decimal numbers (digits, sign, decimal point and exponent) are
+  converted in place using strtod() on a small stack buffer. All other
+  input is converted via QString::toDouble(), so that the accepted
+  syntax is identical to the QString based conversion.
+
+  \return The converted value. \a ok (if not \c NULL) is set to \c
+  true if the conversion was successful, or \c false otherwise.
+
+*/
+{
+  RCsvField f(*this); f.trim();
+  if (ok) *ok=false;
+  if (f.len==0) return 0.;
+
+  char szB[64]; int i; char c; bool isPlain=(f.len<64);
+  for (i=0; i<f.len && isPlain; ++i)
+    {
+      c=f.ptr[i];
+      isPlain=((c>='0' && c<='9') || c=='.' || c=='-' || c=='+' ||
+               c=='e' || c=='E');
+    }
+  if (!isPlain) return QString::fromUtf8(f.ptr,f.len).toDouble(ok);
+
+  memcpy(szB,f.ptr,f.len); szB[f.len]='\0';
+  char *endPtr; double d=strtod(szB,&endPtr);
+  if (endPtr!=szB+f.len) return 0.;
+
+  if (ok) *ok=true;
+  return d;
+}
+
+/**************************************************************************/
+int RCsvField::toInt(bool *ok) const
+/**************************************************************************/
+/*!
+
+  \brief Converts the field to a base 10 integer value.
+
+  Leading and trailing white space and a leading sign are accepted.
+
+  \return The converted value. \a ok (if not \c NULL) is set to \c
+  true if the conversion was successful, or \c false otherwise.
+
+*/
+{
+  RCsvField f(*this); f.trim();
+  if (ok) *ok=false;
+  if (f.len==0) return 0;
+
+  int i=0; bool isNeg=false;
+  if      (f.ptr[0]=='-') { isNeg=true; ++i; }
+  else if (f.ptr[0]=='+') ++i;
+  if (i==f.len) return 0;
+
+  qint64 v=0; char c;
+  for (; i<f.len; ++i)
+    {
+      c=f.ptr[i]; if (c<'0' || c>'9') return 0;
+      v=10*v+(c-'0'); if (v>((qint64) INT_MAX)+1) return 0;
+    }
+  if (isNeg) v=-v;
+  if (v>INT_MAX || v<INT_MIN) return 0;
+
+  if (ok) *ok=true;
+  return (int) v;
+}
+
+/**************************************************************************/
+void RCsvField::trim()
+/**************************************************************************/
+/*!
+
+  \brief Removes leading and trailing white space.
+
+*/
+{
+  while (len>0 && (*ptr==' ' || *ptr=='\t')) { ++ptr; --len; }
+  while (len>0 && (ptr[len-1]==' ' || ptr[len-1]=='\t')) --len;
+}
+
+
+
+/**************************************************************************/
+RCsvTokenizer::RCsvTokenizer(const QString& fn,char splitChar)
+  : file(fn),data(0),size(0),bomSize(0),sepChar(splitChar)
+/**************************************************************************/
+/*!
+
+  \brief Creates a RCsvTokenizer object and maps file \a fn into
+  memory.
+
+  \a splitChar is the column separation character. Use isOpen() to
+  check whether the mapping was successful.
+
+*/
+{
+  if (!file.exists() || !file.open(QIODevice::ReadOnly)) return;
+
+  size=file.size(); if (size==0) return;
+  data=(const char*) file.map(0,size);
+  if (!data) { size=0; return; }
+
+  /* skip a leading UTF-8 byte order mark */
+  if (size>=3 && memcmp(data,"\xEF\xBB\xBF",3)==0) bomSize=3;
+}
+
+/**************************************************************************/
+RCsvTokenizer::~RCsvTokenizer()
+/**************************************************************************/
+/*!
+
+  \brief Unmaps the file.
+
+*/
+{
+  if (data) file.unmap((uchar*) data);
+}
+
+/**************************************************************************/
+qint64 RCsvTokenizer::lineStartAtOrAfter(qint64 pos) const
+/**************************************************************************/
+/*!
+
+  \brief Determines the byte position of the first line starting at
+  or after byte position \a pos.
+
+  \return The determined position, or the byte size of the file if
+  there is no such line.
+
+*/
+{
+  if (pos<=bomSize) return bomSize;
+  if (pos>=size) return size;
+  if (data[pos-1]=='\n') return pos;
+
+  const char *p=(const char*) memchr(data+pos,'\n',size-pos);
+  return (p) ? (p-data)+1 : size;
+}
+
+/**************************************************************************/
+bool RCsvTokenizer::nextLine(qint64& pos,qint64 endPos,RCsvField& line) const
+/**************************************************************************/
+/*!
+
+  \brief Retrieves the line starting at byte position \a pos, if \a
+  pos is less than \a endPos.
+
+  The line terminator ("\n" or "\r\n") is not included in \a line. On
+  exit, \a pos is the byte position of the next line.
+
+  \return \c true if a line was retrieved, or \c false otherwise.
+
+*/
+{
+  if (!data || pos>=endPos || pos>=size) return false;
+
+  const char *s=data+pos;
+  const char *p=(const char*) memchr(s,'\n',size-pos);
+  qint64 n=(p) ? (p-s) : (size-pos);
+  pos+=(p) ? n+1 : n;
+  if (n>0 && s[n-1]=='\r') --n;
+
+  line=RCsvField(s,(int) n);
+  return true;
+}
+
+/**************************************************************************/
+int RCsvTokenizer::split(const RCsvField& line,QVector<RCsvField>& fields) const
+/**************************************************************************/
+/*!
+
+  \brief Splits \a line into column values at every occurrence of the
+  column separation character.
+
+  Like QString::split(), separation characters inside quoted text are
+  not treated specially.
+
+  \return The number of column values in \a fields.
+
+*/
+{
+  fields.resize(0);
+  const char *s=line.ptr,*e=line.ptr+line.len,*p;
+  while ((p=(const char*) memchr(s,sepChar,e-s))!=0)
+    { fields.append(RCsvField(s,(int) (p-s))); s=p+1; }
+  fields.append(RCsvField(s,(int) (e-s)));
+  return fields.size();
+}
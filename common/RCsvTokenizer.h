@@ -0,0 +1,86 @@
+#ifndef RCSVTOKENIZER_H
+#define RCSVTOKENIZER_H
+
+/****************************************************************************
+**
+** Copyright (C) 2025 Reiner Schlitzer. All rights reserved.
+**
+** This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+** WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+**
+****************************************************************************/
+
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+
+/**************************************************************************/
+class RCsvField
+/**************************************************************************/
+/*!
+
+  \brief View of one token (column value or line) inside a memory
+  mapped text buffer.
+
+  An RCsvField does not own any memory. It remains valid as long as
+  the RCsvTokenizer it was obtained from is alive.
+
+*/
+{
+public:
+  RCsvField() : ptr(0),len(0) { }
+  RCsvField(const char *p,int n) : ptr(p),len(n) { }
+
+  char firstChar() const { return (len>0) ? *ptr : '\0'; }
+  bool isEmpty() const { return len==0; }
+  void stripEnclosingChars(char startChar,char endChar);
+  double toDouble(bool *ok=NULL) const;
+  int toInt(bool *ok=NULL) const;
+  QString toString() const { return QString::fromUtf8(ptr,len); }
+  void trim();
+
+  const char *ptr; //!< pointer to the first character
+  int len;         //!< number of characters
+};
+
+
+/**************************************************************************/
+class RCsvTokenizer
+/**************************************************************************/
+/*!
+
+  \brief Memory-mapped, zero-copy tokenizer for delimiter separated
+  UTF-8 text files.
+
+  The entire file is mapped into memory. Lines and column values are
+  handed out as RCsvField views into the mapped buffer, so that no
+  heap allocations occur unless a value is explicitly converted to
+  a QString.
+
+  Line iteration uses an external byte position, so that different
+  byte ranges of the same file can be tokenized concurrently.
+
+*/
+{
+public:
+  RCsvTokenizer(const QString& fn,char splitChar);
+  ~RCsvTokenizer();
+
+  qint64 byteSize() const { return size; }
+  qint64 firstLinePos() const { return bomSize; }
+  bool isOpen() const { return data!=0; }
+  qint64 lineStartAtOrAfter(qint64 pos) const;
+  bool nextLine(qint64& pos,qint64 endPos,RCsvField& line) const;
+  int split(const RCsvField& line,QVector<RCsvField>& fields) const;
+
+private:
+  QFile file;     //!< the mapped file
+  const char *data; //!< pointer to the mapped file contents, or 0
+  qint64 size;    //!< byte size of the mapped file
+  qint64 bomSize; //!< byte size of a leading UTF-8 byte order mark
+  char sepChar;   //!< column separation character
+};
+
+
+#endif   // RCSVTOKENIZER_H
@@ -0,0 +1,109 @@
+/****************************************************************************
+**
+** Copyright (C) 2025 Reiner Schlitzer. All rights reserved.
+**
+** This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+** WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+**
+****************************************************************************/
+
+#include "RRecordWriter.h"
+
+
+/**************************************************************************/
+RRecordWriter::RRecordWriter(const QString& fn,bool deleteExistingFile,
+                             int bufferSize)
+  : file(fn),bufSize(qMax(bufferSize,1024)),ok(false)
+/**************************************************************************/
+/*!
+
+  \brief Creates a RRecordWriter object and opens file \a fn for
+  appending.
+
+  If \a deleteExistingFile is \c true and file \a fn exists, the file
+  is deleted first. \a bufferSize is the number of bytes collected
+  before writing to the file. Use isOk() to check whether the file
+  could be opened.
+
+*/
+{
+  if (fn.isEmpty()) return;
+  if (deleteExistingFile) QFile::remove(fn);
+
+  ok=file.open(QIODevice::Text | QIODevice::Append);
+  if (ok) buf.reserve(bufSize+bufSize/4);
+}
+
+/**************************************************************************/
+RRecordWriter::~RRecordWriter()
+/**************************************************************************/
+/*!
+
+  \brief Writes any buffered text and closes the file.
+
+*/
+{
+  flush();
+}
+
+/**************************************************************************/
+bool RRecordWriter::flush()
+/**************************************************************************/
+/*!
+
+  \brief Writes the buffered text to the file.
+
+  \return \c true if no error occurred so far, or \c false otherwise.
+
+*/
+{
+  if (ok && !buf.isEmpty())
+    ok=(file.write(buf)==buf.size());
+  buf.resize(0);
+  return ok;
+}
+
+/**************************************************************************/
+void RRecordWriter::write(const QString& record)
+/**************************************************************************/
+/*!
+
+  \brief Appends \a record followed by a line break.
+
+*/
+{
+  if (!ok) return;
+  buf.append(record.toUtf8()); buf.append('\n');
+  flushIfFull();
+}
+
+/**************************************************************************/
+void RRecordWriter::write(const QStringList& records)
+/**************************************************************************/
+/*!
+
+  \brief Appends \a records, each followed by a line break.
+
+*/
+{
+  if (!ok) return;
+  int i,n=records.size();
+  for (i=0; i<n; ++i)
+    { buf.append(records.at(i).toUtf8()); buf.append('\n'); }
+  flushIfFull();
+}
+
+/**************************************************************************/
+void RRecordWriter::writeUtf8(const QByteArray& text)
+/**************************************************************************/
+/*!
+
+  \brief Appends the UTF-8 encoded \a text as is. Line breaks must be
+  contained in \a text.
+
+*/
+{
+  if (!ok) return;
+  buf.append(text);
+  flushIfFull();
+}
@@ -0,0 +1,57 @@
+#ifndef RRECORDWRITER_H
+#define RRECORDWRITER_H
+
+/****************************************************************************
+**
+** Copyright (C) 2025 Reiner Schlitzer. All rights reserved.
+**
+** This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+** WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+**
+****************************************************************************/
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QStringList>
+
+
+/**************************************************************************/
+class RRecordWriter
+/**************************************************************************/
+/*!
+
+  \brief Buffered writer appending UTF-8 encoded text records to a
+  file.
+
+  The file is opened once and kept open for the lifetime of the
+  object. Records are collected in a memory buffer, which is written
+  to the file when full, on flush() and on destruction. The output is
+  identical to that of appendRecords().
+
+*/
+{
+public:
+  RRecordWriter(const QString& fn,bool deleteExistingFile=false,
+                int bufferSize=4*1024*1024);
+  ~RRecordWriter();
+
+  bool flush();
+  bool isOk() const { return ok; }
+  void write(const QString& record);
+  void write(const QStringList& records);
+  void writeUtf8(const QByteArray& text);
+
+private:
+  Q_DISABLE_COPY(RRecordWriter)
+
+  void flushIfFull() { if (buf.size()>=bufSize) flush(); }
+
+  QFile file;     //!< the output file
+  QByteArray buf; //!< UTF-8 encoded text not yet written to file
+  int bufSize;    //!< buffer size triggering a write to file
+  bool ok;        //!< no error occurred so far
+};
+
+
+#endif   // RRECORDWRITER_H
@@ -0,0 +1,166 @@
+/****************************************************************************
+**
+** Copyright (C) 2025 Reiner Schlitzer. All rights reserved.
+**
+** This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+** WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+**
+****************************************************************************/
+
+#include "RStringPool.h"
+
+#include <string.h>
+
+#include <QDataStream>
+#include <QtGlobal>
+
+
+/**************************************************************************/
+RStringPool::RStringPool()
+  : stringCount(1)
+/**************************************************************************/
+/*!
+
+  \brief Creates an RStringPool object containing the empty string
+  (ID 0) only.
+
+*/
+{
+  memset(blocks,0,sizeof(blocks));
+  blocks[0]=new QString[blockSize];
+  idsByUtf8.insert(QByteArray(""),0);
+}
+
+/**************************************************************************/
+RStringPool::~RStringPool()
+/**************************************************************************/
+/*!
+
+  \brief Destroys the RStringPool object.
+
+*/
+{
+  int i;
+  for (i=0; i<maxBlockCount && blocks[i]; ++i) delete[] blocks[i];
+}
+
+/**************************************************************************/
+RStringPool& RStringPool::global()
+/**************************************************************************/
+/*!
+
+  \brief \return The application wide string pool.
+
+*/
+{
+  static RStringPool pool;
+  return pool;
+}
+
+/**************************************************************************/
+int RStringPool::idOf(const QString& s) const
+/**************************************************************************/
+/*!
+
+  \brief \return The ID of string \a s, or \c -1 if \a s is not in the
+  pool.
+
+*/
+{
+  QReadLocker locker(&lock);
+  return idsByUtf8.value(s.toUtf8(),-1);
+}
+
+/**************************************************************************/
+int RStringPool::intern(const QString& s)
+/**************************************************************************/
+/*!
+
+  \brief Adds string \a s to the pool, if not yet present.
+
+  \return The ID of \a s.
+
+*/
+{
+  QByteArray ba=s.toUtf8();
+  return intern(ba.constData(),ba.size());
+}
+
+/**************************************************************************/
+int RStringPool::intern(const char *utf8,int len)
+/**************************************************************************/
+/*!
+
+  \brief Adds the UTF-8 encoded string of \a len bytes at \a utf8 to
+  the pool, if not yet present.
+
+  Lookup of strings already in the pool does not copy \a utf8.
+
+  The pool holds up to maxBlockCount*blockSize strings. Since the
+  blocks must never move, the block table cannot grow; running out of
+  blocks aborts the program rather than mapping the string to a wrong
+  ID.
+
+  \return The ID of the string.
+
+*/
+{
+  if (len<=0) return 0;
+
+  QByteArray key=QByteArray::fromRawData(utf8,len); int id;
+
+  /* fast path: string already in pool */
+  {
+    QReadLocker locker(&lock);
+    id=idsByUtf8.value(key,-1); if (id>-1) return id;
+  }
+
+  QWriteLocker locker(&lock);
+  id=idsByUtf8.value(key,-1); if (id>-1) return id;
+
+  id=stringCount.loadAcquire();
+  int blockIdx=id>>blockBits;
+  if (blockIdx>=maxBlockCount)
+    qFatal("RStringPool::intern: pool is full (%d strings)",id);
+  if (!blocks[blockIdx]) blocks[blockIdx]=new QString[blockSize];
+  blocks[blockIdx][id&blockMask]=QString::fromUtf8(utf8,len);
+
+  idsByUtf8.insert(QByteArray(utf8,len),id);
+  stringCount.storeRelease(id+1);
+  return id;
+}
+
+/**************************************************************************/
+QVector<int> RStringPool::internFrom(QDataStream& in)
+/**************************************************************************/
+/*!
+
+  \brief Reads the strings written by writeTo() from binary stream \a
+  in and adds them to the pool.
+
+  \return The mapping of the string IDs in the writing pool (indexes)
+  to the string IDs in this pool (values).
+
+*/
+{
+  qint32 i,n; in >> n;
+  if (in.status()!=QDataStream::Ok || n<1) return QVector<int>(1,0);
+
+  QVector<int> idMap(n,0); QByteArray ba;
+  for (i=1; i<n && in.status()==QDataStream::Ok; ++i)
+    { in >> ba; idMap[i]=intern(ba.constData(),ba.size()); }
+  return idMap;
+}
+
+/**************************************************************************/
+void RStringPool::writeTo(QDataStream& out) const
+/**************************************************************************/
+/*!
+
+  \brief Writes all strings in ID order to binary stream \a out.
+
+*/
+{
+  int i,n=count(); out << (qint32) n;
+  for (i=1; i<n; ++i) out << string(i).toUtf8();
+}
@@ -0,0 +1,68 @@
+#ifndef RSTRINGPOOL_H
+#define RSTRINGPOOL_H
+
+/****************************************************************************
+**
+** Copyright (C) 2025 Reiner Schlitzer. All rights reserved.
+**
+** This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+** WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+**
+****************************************************************************/
+
+#include <QAtomicInt>
+#include <QByteArray>
+#include <QHash>
+#include <QReadWriteLock>
+#include <QString>
+#include <QVector>
+
+class QDataStream;
+
+/**************************************************************************/
+class RStringPool
+/**************************************************************************/
+/*!
+
+  \brief Pool of interned strings.
+
+  Every distinct string is stored exactly once and is identified by a
+  non-negative integer ID. ID 0 always represents the empty string.
+  Equal strings have equal IDs, so that string comparisons reduce to
+  integer comparisons.
+
+  Strings are stored in fixed-size blocks that are never moved, so that
+  string() is lock-free. intern() may be called concurrently from
+  different threads.
+
+*/
+{
+public:
+  RStringPool();
+  ~RStringPool();
+
+  static RStringPool& global();
+
+  int count() const { return stringCount.loadAcquire(); }
+  int idOf(const QString& s) const;
+  int intern(const QString& s);
+  int intern(const char *utf8,int len);
+  QVector<int> internFrom(QDataStream& in);
+  const QString& string(int id) const
+  { return blocks[id>>blockBits][id&blockMask]; }
+  void writeTo(QDataStream& out) const;
+
+private:
+  Q_DISABLE_COPY(RStringPool)
+
+  enum { blockBits=12,blockSize=1<<blockBits,blockMask=blockSize-1,
+         maxBlockCount=8192 };
+
+  QString *blocks[maxBlockCount]; //!< string storage blocks
+  QHash<QByteArray,int> idsByUtf8; //!< string IDs by UTF-8 contents
+  QAtomicInt stringCount;          //!< number of strings in pool
+  mutable QReadWriteLock lock;     //!< protects idsByUtf8 and new blocks
+};
+
+
+#endif   // RSTRINGPOOL_H
@@ -9,6 +9,7 @@
 
 #include "RTable.h"
 
+#include <QDataStream>
 #include <QFile>
 #include <QTextStream>
 
@@ -202,6 +203,31 @@ RTable::RTable(const QStringList& columnLabels,const QString& keyColumnLabel)
     { keyPartLen=-1; keyColIdxs.clear(); header.clear(); }
 }
 
+/**************************************************************************/
+RTable::RTable(QDataStream& in)
+  : keyPartLen(-1)
+/**************************************************************************/
+/*!
+
+  \brief Creates a RTable object and reads column labels, key
+  definition and rows from binary stream \a in.
+
+  \a in must have been written by writeTo(). The order of rows with
+  equal keys is preserved.
+
+*/
+{
+  QStringList sl; QString key; qint32 partLen,n,i;
+  in >> sl >> keyColIdxs >> partLen >> n;
+  header=RTableRow(sl); keyPartLen=partLen;
+
+  for (i=0; i<n && in.status()==QDataStream::Ok; ++i)
+    {
+      in >> key >> sl;
+      insert(key,RTableRow(sl));
+    }
+}
+
 /**************************************************************************/
 void RTable::append(const RTable& other)
 /**************************************************************************/
@@ -472,3 +498,27 @@ QStringList RTable::tokenValues(const QString& key,
 {
   return tokenValues(key,header.indexOf(columnLabel),ok);
 }
+
+/**************************************************************************/
+void RTable::writeTo(QDataStream& out) const
+/**************************************************************************/
+/*!
+
+  \brief Writes column labels, key definition and rows to binary
+  stream \a out.
+
+  Rows are written in reverse order, so that re-inserting them in
+  RTable(QDataStream&) restores the order of rows with equal keys.
+
+*/
+{
+  out << (const QStringList&) header << keyColIdxs << (qint32) keyPartLen
+      << (qint32) size();
+
+  QMultiMap<QString,RTableRow>::ConstIterator it=constEnd();
+  while (it!=constBegin())
+    {
+      --it;
+      out << it.key() << (const QStringList&) it.value();
+    }
+}
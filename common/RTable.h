@@ -14,6 +14,8 @@
 #include <QString>
 #include <QStringList>
 
+class QDataStream;
+
 
 /**************************************************************************/
 class RTableRow : public QStringList
@@ -57,6 +59,7 @@ public:
          const QStringList& keyColumnLabels,int keyPartLength);
   RTable(const QString& fnIn,const QString& keyColumnLabel,QChar splitChar);
   RTable(const QStringList& columnLabels,const QString& keyColumnLabel);
+  RTable(QDataStream& in);
 
   void append(const RTable& other);
   int columnIndexOf(const QString& columnLabel);
@@ -80,6 +83,7 @@ public:
                           int columnIdx,bool &ok) const;
   QStringList tokenValues(const QString& key,
                           const QString& columnLabel,bool &ok) const;
+  void writeTo(QDataStream& out) const;
 
 protected:
   int keyPartLen; //!< length of individual key parts (only used for multi-column keys)
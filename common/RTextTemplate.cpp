@@ -0,0 +1,67 @@
+/****************************************************************************
+**
+** Copyright (C) 2025 Reiner Schlitzer. All rights reserved.
+**
+** This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+** WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+**
+****************************************************************************/
+
+#include "RTextTemplate.h"
+
+
+/**************************************************************************/
+RTextTemplate::RTextTemplate(const QString& text)
+  : literalSize(0)
+/**************************************************************************/
+/*!
+
+  \brief Creates a RTextTemplate object from template text \a text.
+
+  Every occurrence of '%' followed by a digit 1 to 9 is a slot for the
+  value with that number. All other text is literal.
+
+*/
+{
+  int i,start=0,n=text.size(); QChar c;
+  for (i=0; i<n-1; ++i)
+    {
+      c=text.at(i+1);
+      if (text.at(i)==QChar('%') && c>=QChar('1') && c<=QChar('9'))
+        {
+          segments.append(text.mid(start,i-start).toUtf8());
+          slotIdxs.append(c.unicode()-'1');
+          start=i+2; ++i;
+        }
+    }
+  segments.append(text.mid(start).toUtf8());
+
+  for (i=0; i<segments.size(); ++i) literalSize+=segments.at(i).size();
+}
+
+/**************************************************************************/
+QByteArray RTextTemplate::render(const QList<QByteArray>& values) const
+/**************************************************************************/
+/*!
+
+  \brief Substitutes the slots with the UTF-8 encoded values in \a
+  values. Slots without value are left empty.
+
+  \return The UTF-8 encoded result.
+
+*/
+{
+  int i,idx,n=slotIdxs.size(),valueCount=values.size(),size=literalSize;
+  for (i=0; i<n; ++i)
+    if ((idx=slotIdxs.at(i))<valueCount) size+=values.at(idx).size();
+
+  QByteArray ba; ba.reserve(size);
+  for (i=0; i<n; ++i)
+    {
+      ba+=segments.at(i);
+      if ((idx=slotIdxs.at(i))<valueCount) ba+=values.at(idx);
+    }
+  ba+=segments.at(n);
+
+  return ba;
+}
@@ -0,0 +1,48 @@
+#ifndef RTEXTTEMPLATE_H
+#define RTEXTTEMPLATE_H
+
+/****************************************************************************
+**
+** Copyright (C) 2025 Reiner Schlitzer. All rights reserved.
+**
+** This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+** WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+**
+****************************************************************************/
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+
+/**************************************************************************/
+class RTextTemplate
+/**************************************************************************/
+/*!
+
+  \brief Precompiled text template with place markers %1 to %9.
+
+  The template text is split once into UTF-8 encoded literal segments
+  and slots, so that render() only concatenates byte arrays. Unlike
+  chained QString::arg() calls, substituted values are never searched
+  for place markers. Both give identical results if the values do not
+  contain '%'.
+
+  render() may be called concurrently from different threads.
+
+*/
+{
+public:
+  explicit RTextTemplate(const QString& text);
+
+  QByteArray render(const QList<QByteArray>& values) const;
+  int slotCount() const { return slotIdxs.size(); }
+
+private:
+  QList<QByteArray> segments; //!< literal segments (one more than slots)
+  QList<int> slotIdxs;        //!< value index of the slot after each segment
+  int literalSize;            //!< total byte size of all literal segments
+};
+
+
+#endif   // RTEXTTEMPLATE_H
@@ -27,9 +27,10 @@ StationInfo::StationInfo(Station st)
 */
 {
   int i,n=st.size(),nTime=0; EventInfo ei;
-  double *d=(double*) malloc(8*n*sizeof(double));
+  double *d=(double*) malloc(11*n*sizeof(double));
   double *gds=d,*lons=(d+n),*lats=(d+2*n),*botds=(d+3*n);
   double *sLons=(d+4*n),*eLons=(d+5*n),*sLats=(d+6*n),*eLats=(d+7*n);
+  double *dists=(d+8*n),*sDists=(d+9*n),*eDists=(d+10*n);
   double minTime=ODV::largeDOUBLE,maxTime=ODV::missDOUBLE;
   int posLonCount=0,negLonCount=0;
 
@@ -93,12 +94,15 @@ StationInfo::StationInfo(Station st)
   meanTime=gdRv.mean(); sdvTime=gdRv.standardDeviation();
   maxBotd=botdRv.maxValue(); sdvBotd=botdRv.standardDeviation();
 
+  distancesFrom(meanLon,meanLat,n,lons,lats,dists);
+  distancesFrom(meanLon,meanLat,n,sLons,sLats,sDists);
+  distancesFrom(meanLon,meanLat,n,eLons,eLats,eDists);
   maxDist=0.;
   for (i=0; i<n; ++i)
     {
-      maxDist=qMax(maxDist,distance(meanLon,meanLat,lons[i],lats[i]));
-      maxDist=qMax(maxDist,distance(meanLon,meanLat,sLons[i],sLats[i]));
-      maxDist=qMax(maxDist,distance(meanLon,meanLat,eLons[i],eLats[i]));
+      maxDist=qMax(maxDist,dists[i]);
+      maxDist=qMax(maxDist,sDists[i]);
+      maxDist=qMax(maxDist,eDists[i]);
     }
 
   free(d);
@@ -186,6 +190,70 @@ double StationInfo::timeFrom(double refGregDay)
 
 
 
+/**************************************************************************/
+StationMeans::StationMeans()
+/**************************************************************************/
+/*!
+
+  \brief Creates a StationMeans object without events.
+
+*/
+{
+  timeSum=lonSum=shiftedLonSum=latSum=0.;
+  timeCount=lonCount=shiftedLonCount=latCount=posLonCount=negLonCount=0;
+}
+
+/**************************************************************************/
+void StationMeans::add(const EventInfo& ei)
+/**************************************************************************/
+/*!
+
+  \brief Adds the time and position of event \a ei to the sums.
+
+*/
+{
+  double v=meanOf(ei.startGregorianDay,ei.endGregorianDay);
+  if (v!=ODV::missDOUBLE) { timeSum+=v; ++timeCount; }
+  if ((v=ei.latitude)!=ODV::missDOUBLE) { latSum+=v; ++latCount; }
+
+  /* accumulate original and all positive longitudes, because
+    StationInfo shifts the negative longitudes (including missing
+    values) if a station has both, positive and negative ones */
+  if ((v=ei.longitude)!=ODV::missDOUBLE) { lonSum+=v; ++lonCount; }
+  if (v<0.) v+=360.;
+  if (v!=ODV::missDOUBLE) { shiftedLonSum+=v; ++shiftedLonCount; }
+
+  if      (ei.longitude>100.)  ++posLonCount;
+  else if (ei.longitude<-100.) ++negLonCount;
+}
+
+/**************************************************************************/
+double StationMeans::mean(double sum,int count)
+/**************************************************************************/
+/*!
+
+  \brief \return The mean value of \a count values with sum \a sum,
+  or ODV::missDOUBLE if \a count is zero.
+
+*/
+{
+  return (count>0) ? sum/((double) count) : ODV::missDOUBLE;
+}
+
+/**************************************************************************/
+double StationMeans::meanLon() const
+/**************************************************************************/
+/*!
+
+  \brief \return The mean longitude as calculated by StationInfo.
+
+*/
+{
+  return (posLonCount>0 && negLonCount>0) ?
+    mean(shiftedLonSum,shiftedLonCount) : mean(lonSum,lonCount);
+}
+
+
 /**************************************************************************/
 Station::Station()
 /**************************************************************************/
@@ -198,7 +266,7 @@ Station::Station()
 }
 
 /**************************************************************************/
-Station::Station(EventsDB *eventsDB,const QString& bodcEventNumber)
+Station::Station(EventsDB *eventsDB,int bodcEventNumber)
   : Station()
 /**************************************************************************/
 /*!
@@ -209,12 +277,12 @@ Station::Station(EventsDB *eventsDB,const QString& bodcEventNumber)
 */
 {
   /* immediate return if event bodcEventNumber does not exist */
-  if (!eventsDB || !eventsDB->contains(bodcEventNumber)) return;
+  if (!eventsDB || !eventsDB->containsEvent(bodcEventNumber)) return;
   addEvent(eventsDB,bodcEventNumber);
 }
 
 /**************************************************************************/
-bool Station::addEvent(EventsDB *eventsDB,const QString& bodcEventNumber)
+bool Station::addEvent(EventsDB *eventsDB,int bodcEventNumber)
 /**************************************************************************/
 /*!
 
@@ -226,8 +294,8 @@ bool Station::addEvent(EventsDB *eventsDB,const QString& bodcEventNumber)
 {
   /* immediate return if station already contains bodcEventNumber or
     bodcEventNumber is not in the events set */
-  if (contains(bodcEventNumber) ||
-      !eventsDB->contains(bodcEventNumber)) return false;
+  if (eventNumbers.contains(bodcEventNumber) ||
+      !eventsDB->containsEvent(bodcEventNumber)) return false;
 
   EventInfo ei=eventsDB->eventInfoOf(bodcEventNumber);
 
@@ -236,7 +304,8 @@ bool Station::addEvent(EventsDB *eventsDB,const QString& bodcEventNumber)
 
   if (cruiseLbl==ei.cruiseLbl)
     {
-      append(bodcEventNumber); eventInfos.append(ei);
+      append(QString::number(bodcEventNumber)); eventNumbers.insert(bodcEventNumber);
+      eventInfos.append(ei); means.add(ei);
       addStationLabel(ei.stationLbl);
       return true;
     }
@@ -259,7 +328,9 @@ void Station::addStation(const Station& st)
   for (i=0; i<n; ++i)
     {
       append(st.at(i)); eventInfos.append(st.eventInfos.at(i));
+      means.add(st.eventInfos.at(i));
     }
+  eventNumbers.unite(st.eventNumbers);
 }
 
 /**************************************************************************/
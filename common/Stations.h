@@ -10,6 +10,7 @@
 **
 ****************************************************************************/
 
+#include <QSet>
 #include <QString>
 
 #include "globalDefines.h"
@@ -57,6 +58,44 @@ public:
 };
 
 
+/**************************************************************************/
+class StationMeans
+/**************************************************************************/
+/*!
+
+  \brief Running sums of the event times and positions of one Station.
+
+  The sums are accumulated in event order with the same missing value
+  and date line handling as StationInfo, so that meanTime(), meanLon()
+  and meanLat() are identical to the respective StationInfo values, but
+  are available in O(1) after every added event.
+
+*/
+{
+public:
+  StationMeans();
+
+  void add(const EventInfo& ei);
+  double meanLat() const { return mean(latSum,latCount); }
+  double meanLon() const;
+  double meanTime() const { return mean(timeSum,timeCount); }
+
+private:
+  static double mean(double sum,int count);
+
+  double timeSum;        //!< sum of event times as Gregorian days
+  double lonSum;         //!< sum of longitudes
+  double shiftedLonSum;  //!< sum of longitudes shifted to all positive
+  double latSum;         //!< sum of latitudes
+  int timeCount;         //!< number of summed event times
+  int lonCount;          //!< number of summed longitudes
+  int shiftedLonCount;   //!< number of summed shifted longitudes
+  int latCount;          //!< number of summed latitudes
+  int posLonCount;       //!< number of longitudes larger than 100
+  int negLonCount;       //!< number of longitudes smaller than -100
+};
+
+
 /**************************************************************************/
 class Station : public QStringList
 /**************************************************************************/
@@ -70,12 +109,15 @@ class Station : public QStringList
   well as maximum and standard deviation for bottom depth can be obtained
   by creating a StationInfo object for this station.
 
+  The string list holds the BODC event numbers of the events as
+  strings for output.
+
 */
 {
 public:
   Station();
-  Station(EventsDB *eventsDB,const QString& bodcEventNumber);
-  bool addEvent(EventsDB *eventsDB,const QString& bodcEventNumber);
+  Station(EventsDB *eventsDB,int bodcEventNumber);
+  bool addEvent(EventsDB *eventsDB,int bodcEventNumber);
   void addStation(const Station& st);
   void addStationLabel(const QString& lbl);
   EventInfo eventInfoAt(int idx);
@@ -86,6 +128,8 @@ public:
   QString cruiseLbl;
   QStringList stationLbls;
   QList<EventInfo> eventInfos; //!< list of event infos in this station
+  StationMeans means;          //!< running means of time and position
+  QSet<int> eventNumbers;      //!< event numbers in this station
 };
 
 
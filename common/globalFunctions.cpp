@@ -10,6 +10,7 @@
 #include "globalFunctions.h"
 
 #include <math.h>
+#include <stdio.h>
 
 #include <QCryptographicHash>
 #include <QDateTime>
@@ -17,6 +18,7 @@
 #include <QFile>
 #include <QFileInfo>
 #include <QFileInfoList>
+#include <QtNumeric>
 #include <QTextStream>
 
 #include "globalVars.h"
@@ -25,6 +27,68 @@
 // #include "common/odv.h"
 #include "constants.h"
 #include "odv.h"
+#include "systemTools.h"
+
+/**************************************************************************/
+static bool isDecimalRoundingTie(double a,int decCount)
+/**************************************************************************/
+/*!
+
+  \brief \return \c true if the exact decimal expansion of \a a (\a a
+  > 0) ends with a 5 at decimal place \a decCount+1, i.e., if rounding
+  to \a decCount decimal places is an exact tie.
+
+  A double with f fractional binary digits has exactly f fractional
+  decimal digits, the last of which is a 5.
+
+*/
+{
+  int e; double m=frexp(a,&e);
+  qint64 mantissa=(qint64) ldexp(m,53); int fracDigits=53-e;
+  while (fracDigits>0 && (mantissa&1)==0) { mantissa>>=1; --fracDigits; }
+  return fracDigits==decCount+1;
+}
+
+/**************************************************************************/
+static int fixedFormattedNumber(double d,int decCount,bool doChopTrailingZeros,
+                                char *szB,int bufSize)
+/**************************************************************************/
+/*!
+
+  \brief Fast path of formattedNumber() for numbers in fixed point
+  notation. Formats \a d into character buffer \a szB of size \a
+  bufSize using snprintf().
+
+  snprintf() and Qt both round correctly, but differ for exact ties
+  (round-half-even vs. round-half-up) and for negative numbers rounding
+  to zero. These cases, non-finite numbers and numbers in exponent
+  notation are left to the Qt formatting.
+
+  \return The number of characters in \a szB, or \c -1 if the fast
+  path does not apply.
+
+*/
+{
+  if (!qIsFinite(d) || decCount<0) return -1;
+
+  double a=fabs(d),b=floor(a); if ((a-b)<1.e-8 && doChopTrailingZeros) decCount=0;
+  if (a>=1.e15 || decCount>17) return -1;
+  if (decCount>0 && a!=0. && (a<1.e-5 || a>1.e6)) return -1;
+  if (a!=0. && isDecimalRoundingTie(a,decCount)) return -1;
+
+  int i,len=snprintf(szB,bufSize,"%.*f",decCount,d);
+  if (len<1 || len>=bufSize) return -1;
+  if (decCount>0 && (len<decCount+2 || szB[len-decCount-1]!='.')) return -1;
+  if (szB[0]=='-')
+    {
+      for (i=1; i<len && (szB[i]=='0' || szB[i]=='.'); ++i) ;
+      if (i==len) return -1;
+    }
+
+  if (doChopTrailingZeros && decCount>0)
+    while (szB[len-1]=='0') --len;
+  return len;
+}
 
 /**************************************************************************/
 double adjustedLongitude(double lon)
@@ -41,6 +105,27 @@ double adjustedLongitude(double lon)
   return lon;
 }
 
+/**************************************************************************/
+void appendFormattedNumber(QString& str,double d,int decCount,
+                           bool doChopTrailingZeros,bool clearMissDouble)
+/**************************************************************************/
+/*!
+
+  \brief Appends the string representation of \a d to \a str.
+
+  The result is identical to appending formattedNumber(d, decCount,
+  doChopTrailingZeros, clearMissDouble), but numbers in fixed point
+  notation are formatted without temporary strings.
+
+*/
+{
+  if (d==ODV::missDOUBLE && clearMissDouble) return;
+
+  char szB[64]; int len=fixedFormattedNumber(d,decCount,doChopTrailingZeros,szB,64);
+  if (len>-1) str.append(QLatin1String(szB,len));
+  else        str+=formattedNumber(d,decCount,doChopTrailingZeros,clearMissDouble);
+}
+
 /**************************************************************************/
 bool appendRecord(const QString& fn,const QString& record,
                   bool deleteExistingFile)
@@ -365,6 +450,29 @@ QString dateStampedFileName(const QString& fn,const QString& ext)
   return fn+"_"+currentDateTimeAsFileNamePart()+"."+ext;
 }
 
+/**************************************************************************/
+bool decimalStringLessThan(int a,int b)
+/**************************************************************************/
+/*!
+
+  \brief \return \c true if QString::number(\a a) sorts before
+  QString::number(\a b), without converting the numbers to strings.
+
+*/
+{
+  /* negative numbers start with '-', which sorts before all digits */
+  if ((a<0)!=(b<0)) return a<0;
+
+  /* scale the number with fewer digits to the digit count of the other
+    one. on equal leading digits the shorter string sorts first. */
+  qint64 x=qAbs((qint64) a),y=qAbs((qint64) b),px=1,py=1;
+  while (px<=x/10) px*=10;
+  while (py<=y/10) py*=10;
+  if      (px<py) x*=py/px;
+  else if (py<px) y*=px/py;
+  return (x!=y) ? x<y : px<py;
+}
+
 /**************************************************************************/
 void decomposeName(const QString fullName,QString& firstName,QString& lastName)
 /**************************************************************************/
@@ -448,6 +556,36 @@ double distance(double lon1,double lat1,double lon2,double lat2)
     }
 }
 
+/**************************************************************************/
+void distancesFrom(double refLon,double refLat,int n,
+                   const double *lons,const double *lats,double *dists)
+/**************************************************************************/
+/*!
+  \brief Calculates the distances (in km) of the \a n points with
+  lon/lat coordinates \a lons / \a lats from reference point \a
+  refLon / \a refLat and stores them in \a dists.
+
+  The results are identical to distance(refLon,refLat,lons[i],lats[i]).
+  Points less than one degree latitude away, the common case when
+  collating stations, need a single integration step only, which is
+  evaluated inline.
+*/
+{
+  const double fac=111.194929; int i; double dlon,dlat;
+
+  for (i=0; i<n; ++i)
+    {
+      dlon=lons[i]-refLon; dlat=lats[i]-refLat;
+      if      (dlon==0.)      dists[i]=fabs(fac*dlat);
+      else if (fabs(dlat)<1.)
+        {
+          dlon=fac*cos(DEG2RAD*(refLat+0.5*dlat))*dlon; dlat=fac*dlat;
+          dists[i]=sqrt(dlat*dlat+dlon*dlon);
+        }
+      else                    dists[i]=distance(refLon,refLat,lons[i],lats[i]);
+    }
+}
+
 /**************************************************************************/
 QMap<QString,QString> eGeotracesVarDescriptions(RConfig& varsCf)
 /**************************************************************************/
@@ -626,10 +764,16 @@ QString formattedNumber(double d,int decCount,bool doChopTrailingZeros,
 
   \a decCount is the number of significant digits to be used.
 
+  Numbers in fixed point notation are formatted with snprintf() where
+  this gives the same result (see fixedFormattedNumber()).
+
 */
 {
   if (d==ODV::missDOUBLE && clearMissDouble) return QString();
 
+  char szB[64]; int len=fixedFormattedNumber(d,decCount,doChopTrailingZeros,szB,64);
+  if (len>-1) return QString::fromLatin1(szB,len);
+
   double a=fabs(d),b=floor(a); if ((a-b)<1.e-8 && doChopTrailingZeros) decCount=0;
   QString n=(decCount>0 && a!=0. && (a<1.e-5 || a>1.e6)) ?
     QString::number(d,'g',decCount+3) : QString("%1").arg(d,0,'f',decCount);
@@ -1188,3 +1332,19 @@ QString toLastNameFirstName(const QString& fullName,
   QString firstName,lastName; decomposeName(fullName,firstName,lastName);
   return toLastNameFirstName(firstName,lastName,separator);
 }
+
+/**************************************************************************/
+int workerThreadCount(int requestedCount)
+/**************************************************************************/
+/*!
+
+  \brief Determines the number of worker threads for parallel tasks.
+
+  \return \a requestedCount if positive, otherwise \a idpThreadCount
+  if positive, otherwise the number of processor cores.
+
+*/
+{
+  if (requestedCount>0) return requestedCount;
+  return (idpThreadCount>0) ? idpThreadCount : idealThreadCount();
+}
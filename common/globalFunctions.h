@@ -19,6 +19,8 @@
 class RTable;
 
 /**global functions*******************************************************/
+void appendFormattedNumber(QString& str,double d,int decCount,
+                           bool doChopTrailingZeros=false,bool clearMissDouble=true);
 bool appendRecord(const QString& fn,const QString& record,
                   bool deleteExistingFile=false);
 bool appendRecords(const QString& fn,const QStringList& records,
@@ -36,11 +38,14 @@ int copyDir(const QString& src,const QString& trg,const QString& filter);
 QString currentDateTimeAsFileNamePart();
 QStringList dataGeneratorNameList(const QString& str,const QString& splitStr);
 QString dateStampedFileName(const QString& fn,const QString& ext=QString("txt"));
+bool decimalStringLessThan(int a,int b);
 void decomposeName(const QString fullName,QString& firstName,QString& lastName);
 void decomposePath(const QString filePath,QString& dirPath,QString& fn);
 void decomposePathEx(const QString& filePath,
                      QString& dirPath,QString& fn,QString& fileExt);
 double distance(double lon1,double lat1,double lon2,double lat2);
+void distancesFrom(double refLon,double refLat,int n,
+                   const double *lons,const double *lats,double *dists);
 QMap<QString,QString> eGeotracesVarDescriptions(RConfig& varsCf);
 QMap<QString,QString> eGeotracesVars(RConfig& varsCf);
 double extractedDouble(const QString& valStr);
@@ -81,6 +86,7 @@ QString toLastNameFirstName(const QString& firstName,const QString& lastName,
                             const QString& separator=QString(", "));
 QString toLastNameFirstName(const QString& fullName,
                             const QString& separator=QString(", "));
+int workerThreadCount(int requestedCount=0);
 
 /**************************************************************************/
 template <typename T>
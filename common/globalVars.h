@@ -48,6 +48,11 @@ const QString unitConversionFilePathAerosolRain=idpInputDir
 const QString editorCmd="C:/Programs/emacs/bin/runemacs.exe";
 const QString odvCmd="C:/Programs/Ocean Data View/bin_w64/odv.exe";
 
+const int idpThreadCount=0; // worker threads (0: number of processor cores)
+const int idpConcurrentProducts=4; // data type products built concurrently (1: one after the other)
+const bool packInfoFiles=false; // pack the info files of a product into infos.pack and infos.manifest (links need a manifest resolver; ODV cannot open them)
+const bool useInputSnapshots=true; // reload unchanged inputs from binary snapshots
+
 const QString jsHeader="/****************************************************************************\n**\n** Copyright (C) 2025 Reiner Schlitzer. All rights reserved.\n**\n** This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE\n** WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.\n**\n****************************************************************************/\n\n";
 
 const QString fmtDvDef="//<DataVariable>label=\"%1\" value_type=\"%2\" qf_schema=\"SEADATANET\" significant_digits=\"%3\" is_primary_variable=\"%4\" comment=\"%5\" key_variable=\"%6\"</DataVariable>";